@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "AdaptiveDiffusion.h"
 
 namespace AdaptiveDiffusion {
@@ -5,6 +6,29 @@ namespace AdaptiveDiffusion {
     size_t Eta = 4;
     size_t maxDepth = 4;
     size_t propagationDelay = 100;
+    // announce the digest of flooded payloads instead of pushing them,
+    // the neighbors pull the payload from the first announcer
+    bool lazyPush = false;
+    size_t lazyPushThreshold = 1024;
+
+    std::vector<uint32_t> selectNeighbors(const std::vector<uint32_t>& neighbors, uint32_t excluded,
+                                         CryptoPP::RandomNumberGenerator& PRNG) {
+        std::vector<uint32_t> candidates;
+        candidates.reserve(neighbors.size());
+        for(uint32_t neighbor : neighbors) {
+            if(neighbor != excluded)
+                candidates.push_back(neighbor);
+        }
+
+        // partial Fisher-Yates shuffle
+        size_t count = std::min(Eta, candidates.size());
+        for(size_t i = 0; i < count; i++) {
+            size_t j = PRNG.GenerateWord32(i, candidates.size() - 1);
+            std::swap(candidates[i], candidates[j]);
+        }
+        candidates.resize(count);
+        return candidates;
+    }
 };
 
 
@@ -3,6 +3,8 @@
 
 #include <cstdint>
 #include <cmath>
+#include <vector>
+#include <cryptopp/cryptlib.h>
 #include "../datastruct/MessageQueue.h"
 #include "../datastruct/OutgoingMessage.h"
 #include "../utils/Utils.h"
@@ -12,6 +14,12 @@ namespace AdaptiveDiffusion {
     extern size_t Eta;
     extern size_t maxDepth;
     extern size_t propagationDelay;
+    extern bool lazyPush;
+    extern size_t lazyPushThreshold;
+
+    // selects up to Eta distinct neighbors uniformly at random, excluding the given connection
+    std::vector<uint32_t> selectNeighbors(const std::vector<uint32_t>& neighbors, uint32_t excluded,
+                                         CryptoPP::RandomNumberGenerator& PRNG);
 };
 
 
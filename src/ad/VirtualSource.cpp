@@ -15,11 +15,7 @@ VirtualSource::VirtualSource(uint32_t nodeID, std::vector<uint32_t>& neighbors,
   randomEngine_(std::random_device()()), uniformDistribution_(0, 1), safetyMechanism_(safetyMechanism) {
 
     // select a random subset of neighbors
-    while(neighbors_.size() < std::min(AdaptiveDiffusion::Eta, neighbors.size()-1)) {
-        uint32_t neighbor = PRNG.GenerateWord32(0, neighbors.size()-1);
-        if(neighbor != VSToken.connectionID())
-            neighbors_.insert(neighbors[neighbor]);
-    }
+    neighbors_ = AdaptiveDiffusion::selectNeighbors(neighbors, VSToken.connectionID(), PRNG);
 
     s = (VSToken.body()[0] << 8) | VSToken.body()[1];
     h = (VSToken.body()[2] << 8) | VSToken.body()[3];
@@ -70,8 +66,7 @@ void VirtualSource::executeTask() {
     if(s == 0) {
         // Create the initial VS Token
         // select a random neighbor
-        uint32_t r = PRNG.GenerateWord32(0, neighbors_.size() - 1);
-        uint32_t v_next = *std::next(neighbors_.begin(), r);
+        uint32_t v_next = neighbors_[PRNG.GenerateWord32(0, neighbors_.size() - 1)];
 
         // first forward the message
         OutgoingMessage adForward(v_next, AdaptiveDiffusionForward, nodeID_, message_);
@@ -95,8 +90,7 @@ void VirtualSource::executeTask() {
             if (p(s, h) <= uniformDistribution_(randomEngine_)) {
                 VirtualSource::spreadMessage();
             } else {
-                uint32_t r = PRNG.GenerateWord32(0, neighbors_.size() - 1);
-                uint32_t v_next = *std::next(neighbors_.begin(), r);
+                uint32_t v_next = neighbors_[PRNG.GenerateWord32(0, neighbors_.size() - 1)];
                 std::vector<uint8_t> VSToken = generateVSToken(s, h, message_);
                 OutgoingMessage vsForward(v_next, VirtualSourceToken, nodeID_, std::move(VSToken));
                 outboxThreePP_.push(std::move(vsForward));
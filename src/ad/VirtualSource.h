@@ -36,7 +36,7 @@ private:
 
     std::vector<uint8_t> message_;
 
-    std::set<uint32_t> neighbors_;
+    std::vector<uint32_t> neighbors_;
 
     MessageQueue<OutgoingMessage>& outboxThreePP_;
 
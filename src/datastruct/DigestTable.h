@@ -0,0 +1,118 @@
+#ifndef THREEPP_DIGESTTABLE_H
+#define THREEPP_DIGESTTABLE_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "ReceivedMessage.h"
+
+// Open addressing hash table with linear probing, keyed by message digests.
+// The entries are additionally kept in a ring buffer in the order of insertion,
+// which allows to evict the oldest entry in constant time.
+// The entry type T has to provide the members 'bool occupied' and 'MessageDigest digest'.
+template<class T>
+class DigestTable {
+public:
+    DigestTable(size_t capacity) : capacity_(capacity), FIFOBuffer_(capacity), FIFOHead_(0), FIFOSize_(0) {
+        // keep the load factor of the table below 0.5
+        size_t tableSize = 16;
+        while (tableSize < 2 * capacity_)
+            tableSize <<= 1;
+
+        table_.resize(tableSize);
+        mask_ = tableSize - 1;
+    }
+
+    T* find(const MessageDigest& digest) {
+        size_t index = position(digest);
+        return index == table_.size() ? nullptr : &table_[index];
+    }
+
+    // inserts a new entry, the oldest entry is evicted if the table is full
+    T& insert(const MessageDigest& digest) {
+        if (FIFOSize_ == capacity_)
+            popOldest();
+
+        FIFOBuffer_[(FIFOHead_ + FIFOSize_) % capacity_] = digest;
+        FIFOSize_++;
+
+        size_t index = homeIndex(digest);
+        while (table_[index].occupied)
+            index = (index + 1) & mask_;
+
+        T& entry = table_[index];
+        entry.occupied = true;
+        entry.digest = digest;
+        return entry;
+    }
+
+    T* oldest() {
+        return FIFOSize_ > 0 ? find(FIFOBuffer_[FIFOHead_]) : nullptr;
+    }
+
+    void popOldest() {
+        if (FIFOSize_ == 0)
+            return;
+
+        erase(position(FIFOBuffer_[FIFOHead_]));
+        FIFOHead_ = (FIFOHead_ + 1) % capacity_;
+        FIFOSize_--;
+    }
+
+    size_t size() {
+        return FIFOSize_;
+    }
+
+private:
+    // the digests are uniformly distributed, therefore the first 8 bytes suffice as hash value
+    inline size_t homeIndex(const MessageDigest& digest) {
+        uint64_t prefix;
+        std::memcpy(&prefix, digest.data(), sizeof(prefix));
+        return prefix & mask_;
+    }
+
+    size_t position(const MessageDigest& digest) {
+        for (size_t index = homeIndex(digest); table_[index].occupied; index = (index + 1) & mask_) {
+            if (table_[index].digest == digest)
+                return index;
+        }
+        return table_.size();
+    }
+
+    void erase(size_t index) {
+        if (index == table_.size())
+            return;
+
+        // backward shift deletion, which keeps the probe sequences intact without tombstones
+        size_t next = index;
+        for (;;) {
+            next = (next + 1) & mask_;
+            if (!table_[next].occupied)
+                break;
+
+            // move the entry only if its home position is not located between the gap and its current position
+            size_t home = homeIndex(table_[next].digest);
+            if (((next - home) & mask_) >= ((next - index) & mask_)) {
+                table_[index] = std::move(table_[next]);
+                index = next;
+            }
+        }
+        table_[index] = T();
+    }
+
+    size_t capacity_;
+
+    std::vector<T> table_;
+
+    size_t mask_;
+
+    // ring buffer storing the digests in the order of insertion
+    std::vector<MessageDigest> FIFOBuffer_;
+
+    size_t FIFOHead_;
+
+    size_t FIFOSize_;
+};
+
+#endif //THREEPP_DIGESTTABLE_H
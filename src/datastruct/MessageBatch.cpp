@@ -0,0 +1,44 @@
+#include "MessageBatch.h"
+
+MessageBatch::MessageBatch(size_t maxPayloadSize) : maxPayloadSize_(maxPayloadSize) {}
+
+bool MessageBatch::add(const std::vector<uint8_t>& message) {
+    if (payload_.size() + FRAME_HEADER_SIZE + message.size() > maxPayloadSize_)
+        return false;
+
+    if (payload_.empty())
+        opened_ = std::chrono::steady_clock::now();
+
+    payload_.push_back((message.size() & 0xFF00) >> 8);
+    payload_.push_back(message.size() & 0x00FF);
+    payload_.insert(payload_.end(), message.begin(), message.end());
+    return true;
+}
+
+bool MessageBatch::empty() {
+    return payload_.empty();
+}
+
+std::chrono::steady_clock::time_point MessageBatch::opened() {
+    return opened_;
+}
+
+std::vector<uint8_t>& MessageBatch::payload() {
+    return payload_;
+}
+
+std::vector<std::vector<uint8_t>> MessageBatch::unpack(const std::vector<uint8_t>& payload) {
+    std::vector<std::vector<uint8_t>> messages;
+
+    size_t offset = 0;
+    while (offset + FRAME_HEADER_SIZE <= payload.size()) {
+        size_t length = (payload[offset] << 8) | payload[offset + 1];
+        offset += FRAME_HEADER_SIZE;
+        if (offset + length > payload.size())
+            break;
+
+        messages.emplace_back(payload.begin() + offset, payload.begin() + offset + length);
+        offset += length;
+    }
+    return messages;
+}
@@ -0,0 +1,42 @@
+#ifndef THREEPP_MESSAGEBATCH_H
+#define THREEPP_MESSAGEBATCH_H
+
+#include <cstdint>
+#include <vector>
+#include <chrono>
+
+// Packs several submitted messages into the payload of a single slot.
+// Each message is preceded by its length (2 bytes) in Big Endian format.
+class MessageBatch {
+public:
+    // the size of a slot is limited to 2^16 - 1 Bytes
+    static const size_t MAX_PAYLOAD_SIZE = 0xFFFF;
+
+    static const size_t FRAME_HEADER_SIZE = 2;
+
+    // the payload of a leased slot is limited by the lease header
+    MessageBatch(size_t maxPayloadSize = MAX_PAYLOAD_SIZE);
+
+    // returns false if the message does not fit into the remaining space of the batch
+    bool add(const std::vector<uint8_t>& message);
+
+    bool empty();
+
+    // time at which the first message has been added
+    std::chrono::steady_clock::time_point opened();
+
+    std::vector<uint8_t>& payload();
+
+    // splits a received payload into its messages, a truncated frame ends the payload
+    static std::vector<std::vector<uint8_t>> unpack(const std::vector<uint8_t>& payload);
+
+private:
+    size_t maxPayloadSize_;
+
+    std::vector<uint8_t> payload_;
+
+    std::chrono::steady_clock::time_point opened_;
+};
+
+
+#endif //THREEPP_MESSAGEBATCH_H
@@ -1,86 +1,186 @@
+#include <algorithm>
 #include "MessageBuffer.h"
 #include "MessageType.h"
-#include "../utils/Utils.h"
 
-MessageBuffer::MessageBuffer(size_t maxCapacity) : maxCapacity_(maxCapacity) {}
+// number of digests remembered per buffered payload
+const size_t SEEN_TIER_FACTOR = 16;
+
+MessageBuffer::MessageBuffer(size_t maxCapacity, size_t maxMemory, std::chrono::milliseconds payloadTTL)
+: maxCapacity_(maxCapacity), maxMemory_(maxMemory), usedMemory_(0), payloadTTL_(payloadTTL), seenTTL_(8 * payloadTTL), payloadTier_(maxCapacity),
+  seenTier_(SEEN_TIER_FACTOR * maxCapacity) {}
+
+MessageBuffer::PayloadEntry& MessageBuffer::emplace(ReceivedMessage& msg, Timestamp now) {
+    // evict the oldest payloads until the new message fits into the buffer
+    while ((payloadTier_.size() == maxCapacity_)
+           || ((payloadTier_.size() > 0) && (usedMemory_ + msg.body().size() > maxMemory_))) {
+        demoteOldest();
+        statistics_.prematureEvictions++;
+    }
+
+    PayloadEntry& entry = payloadTier_.insert(msg.digest());
+    entry.msgType = msg.msgType();
+    entry.senderID = msg.senderID();
+    entry.received = now;
+    entry.payload = std::make_shared<std::vector<uint8_t>>(msg.body());
+
+    usedMemory_ += entry.payload->size();
+    return entry;
+}
+
+void MessageBuffer::demoteOldest() {
+    PayloadEntry* oldest = payloadTier_.oldest();
+    if (oldest == nullptr)
+        return;
+
+    SeenEntry& seen = seenTier_.insert(oldest->digest);
+    seen.msgType = oldest->msgType;
+    seen.senderID = oldest->senderID;
+    seen.received = oldest->received;
+
+    usedMemory_ -= oldest->payload->size();
+    payloadTier_.popOldest();
+}
+
+void MessageBuffer::expire(Timestamp now) {
+    for (PayloadEntry* oldest = payloadTier_.oldest();
+         (oldest != nullptr) && (now - oldest->received > payloadTTL_); oldest = payloadTier_.oldest()) {
+        demoteOldest();
+        statistics_.expiredPayloads++;
+    }
+
+    for (SeenEntry* oldest = seenTier_.oldest();
+         (oldest != nullptr) && (now - oldest->received > seenTTL_); oldest = seenTier_.oldest())
+        seenTier_.popOldest();
+}
+
+void MessageBuffer::observeDuplicate(Timestamp received, Timestamp now) {
+    // keep the payloads at least twice as long as the latest duplicate arrived,
+    // but never longer than the digests are remembered
+    auto age = std::chrono::duration_cast<std::chrono::milliseconds>(now - received);
+    payloadTTL_ = std::max(payloadTTL_, std::min(2 * age, seenTTL_));
+}
 
 bool MessageBuffer::contains(ReceivedMessage& msg) {
-    std::string msgHash = utils::sha256(msg.body());
+    return contains(msg.digest());
+}
+
+bool MessageBuffer::contains(const MessageDigest& digest) {
+    Timestamp now = std::chrono::system_clock::now();
+    expire(now);
 
-    auto position = indexBuffer_.find(msgHash);
-    if(position != indexBuffer_.end())
+    PayloadEntry* entry = payloadTier_.find(digest);
+    if (entry != nullptr) {
+        observeDuplicate(entry->received, now);
         return true;
+    }
 
+    SeenEntry* seen = seenTier_.find(digest);
+    if (seen != nullptr) {
+        observeDuplicate(seen->received, now);
+        statistics_.seenTierHits++;
+        return true;
+    }
     return false;
 }
 
 // Flood and Prune insert
-int MessageBuffer::insert(ReceivedMessage msg) {
-    std::string msgHash = utils::sha256(msg.body());
-
-    auto position = indexBuffer_.find(msgHash);
-    if(position == indexBuffer_.end()) {
-        if (FIFOBuffer_.size() == maxCapacity_) {
-            indexBuffer_.erase(FIFOBuffer_.front());
-            FIFOBuffer_.pop();
-        }
-
-        FIFOBuffer_.push(msgHash);
-        indexBuffer_.insert(std::pair(msgHash, std::pair(msg, std::set<uint32_t>())));
-    } else if(position->second.first.msgType() == AdaptiveDiffusionForward) {
+int MessageBuffer::insert(ReceivedMessage& msg) {
+    Timestamp now = std::chrono::system_clock::now();
+    expire(now);
+
+    PayloadEntry* entry = payloadTier_.find(msg.digest());
+    SeenEntry* seen = seenTier_.find(msg.digest());
+    if (entry != nullptr) {
         // update the message type
-        position->second.first.updateMsgType(FloodAndPrune);
+        if (entry->msgType == AdaptiveDiffusionForward)
+            entry->msgType = FloodAndPrune;
+    } else if (seen != nullptr) {
+        if (seen->msgType == AdaptiveDiffusionForward)
+            seen->msgType = FloodAndPrune;
+    } else {
+        emplace(msg, now);
     }
     return 0;
 }
 
 // Adaptive Diffusion insert
-int MessageBuffer::insert(ReceivedMessage msg, std::set<uint32_t> neighbors) {
-    std::string msgHash = utils::sha256(msg.body());
-
-    auto position = indexBuffer_.find(msgHash);
-    if(position == indexBuffer_.end()) {
-        if (FIFOBuffer_.size() == maxCapacity_) {
-            indexBuffer_.erase(FIFOBuffer_.front());
-            FIFOBuffer_.pop();
-        }
-
-        FIFOBuffer_.push(msgHash);
-        indexBuffer_.insert(std::pair(msgHash, std::pair(msg, neighbors)));
+int MessageBuffer::insert(ReceivedMessage& msg, std::vector<uint32_t> neighbors) {
+    Timestamp now = std::chrono::system_clock::now();
+    expire(now);
+
+    if ((payloadTier_.find(msg.digest()) == nullptr) && (seenTier_.find(msg.digest()) == nullptr)) {
+        PayloadEntry& entry = emplace(msg, now);
+        entry.neighbors = std::move(neighbors);
     }
     return 0;
 }
 
 uint8_t MessageBuffer::getType(ReceivedMessage& msg) {
-    std::string msgHash = utils::sha256(msg.body());
+    return getType(msg.digest());
+}
+
+uint8_t MessageBuffer::getType(const MessageDigest& digest) {
+    PayloadEntry* entry = payloadTier_.find(digest);
+    if (entry != nullptr)
+        return entry->msgType;
 
-    auto position = indexBuffer_.find(msgHash);
-    if(position != indexBuffer_.end())
-        return position->second.first.msgType();
+    SeenEntry* seen = seenTier_.find(digest);
+    if (seen != nullptr)
+        return seen->msgType;
 
     return 0xFF;
 }
 
 uint32_t MessageBuffer::getSenderID(ReceivedMessage &msg) {
-    std::string msgHash = utils::sha256(msg.body());
+    PayloadEntry* entry = payloadTier_.find(msg.digest());
+    if (entry != nullptr)
+        return entry->senderID;
 
-    auto position = indexBuffer_.find(msgHash);
-    if(position != indexBuffer_.end())
-        return position->second.first.senderID();
+    SeenEntry* seen = seenTier_.find(msg.digest());
+    if (seen != nullptr)
+        return seen->senderID;
 
     return 0xFFFFFFFB;
 }
 
-std::set<uint32_t> & MessageBuffer::getSelectedNeighbors(ReceivedMessage &msg) {
-    std::string msgHash = utils::sha256(msg.body());
+std::vector<uint32_t>& MessageBuffer::getSelectedNeighbors(ReceivedMessage &msg) {
+    PayloadEntry* entry = payloadTier_.find(msg.digest());
+    if (entry != nullptr)
+        return entry->neighbors;
+
+    return emptyNeighbors_;
+}
+
+std::shared_ptr<std::vector<uint8_t>> MessageBuffer::getPayload(const MessageDigest& msgHash) {
+    PayloadEntry* entry = payloadTier_.find(msgHash);
+    if (entry != nullptr)
+        return entry->payload;
 
-    auto position = indexBuffer_.find(msgHash);
-    if(position != indexBuffer_.end())
-        return position->second.second;
+    return nullptr;
+}
 
-    return emptySet_;
+void MessageBuffer::markPeer(ReceivedMessage& msg, uint32_t connectionID) {
+    markPeer(msg.digest(), connectionID);
 }
 
-ReceivedMessage MessageBuffer::getMessage(std::string& msgHash) {
-    return indexBuffer_[msgHash].first;
+void MessageBuffer::markPeer(const MessageDigest& digest, uint32_t connectionID) {
+    PayloadEntry* entry = payloadTier_.find(digest);
+    if (entry != nullptr)
+        entry->peers.insert(connectionID);
 }
+
+bool MessageBuffer::peerHasMessage(ReceivedMessage& msg, uint32_t connectionID) {
+    PayloadEntry* entry = payloadTier_.find(msg.digest());
+    if (entry != nullptr)
+        return entry->peers.count(connectionID) > 0;
+
+    return false;
+}
+
+MessageBuffer::Statistics& MessageBuffer::statistics() {
+    return statistics_;
+}
+
+std::chrono::milliseconds MessageBuffer::payloadTTL() {
+    return payloadTTL_;
+}
\ No newline at end of file
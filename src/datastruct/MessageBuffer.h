@@ -2,40 +2,135 @@
 #define THREEPP_MESSAGEBUFFER_H
 
 #include <cstdint>
-#include <queue>
 #include <set>
 #include <string>
 #include <memory>
-#include <unordered_map>
+#include <vector>
+#include <chrono>
 
 #include "ReceivedMessage.h"
+#include "DigestTable.h"
 
 class MessageBuffer {
 public:
-    MessageBuffer(size_t max_size);
+    struct Statistics {
+        // duplicates which have been dropped without being forwarded
+        uint64_t duplicatesSuppressed = 0;
 
-    int insert(ReceivedMessage msg);
+        // messages of the adaptive diffusion phase which continued with the flood and prune phase
+        uint64_t floodTransitions = 0;
 
-    int insert(ReceivedMessage msg, std::set<uint32_t> neighbors);
+        // messages which have been flooded again after their payload had been evicted
+        uint64_t reFloods = 0;
+
+        // duplicates which have only been recognized by the digest tier,
+        // since the payload had already been evicted
+        uint64_t seenTierHits = 0;
+
+        // payloads evicted by the capacity or memory bound before their TTL elapsed
+        uint64_t prematureEvictions = 0;
+
+        uint64_t expiredPayloads = 0;
+    };
+
+    static const size_t DEFAULT_CAPACITY = 128;
+
+    static const size_t DEFAULT_MEMORY = 64 * 1024 * 1024;
+
+    MessageBuffer(size_t maxCapacity, size_t maxMemory = DEFAULT_MEMORY,
+                  std::chrono::milliseconds payloadTTL = std::chrono::milliseconds(3200));
+
+    int insert(ReceivedMessage& msg);
+
+    int insert(ReceivedMessage& msg, std::vector<uint32_t> neighbors);
 
     bool contains(ReceivedMessage& msg);
 
+    bool contains(const MessageDigest& digest);
+
     uint8_t getType(ReceivedMessage& msg);
 
+    uint8_t getType(const MessageDigest& digest);
+
     uint32_t getSenderID(ReceivedMessage& msg);
 
-    std::set<uint32_t>& getSelectedNeighbors(ReceivedMessage& msg);
+    std::vector<uint32_t>& getSelectedNeighbors(ReceivedMessage& msg);
 
-    ReceivedMessage getMessage(std::string& msgHash);
+    std::shared_ptr<std::vector<uint8_t>> getPayload(const MessageDigest& msgHash);
+
+    // remembers that the given connection already holds the message
+    void markPeer(ReceivedMessage& msg, uint32_t connectionID);
+
+    void markPeer(const MessageDigest& digest, uint32_t connectionID);
+
+    bool peerHasMessage(ReceivedMessage& msg, uint32_t connectionID);
+
+    Statistics& statistics();
+
+    std::chrono::milliseconds payloadTTL();
 
 private:
+    struct PayloadEntry {
+        bool occupied = false;
+
+        uint8_t msgType;
+
+        uint32_t senderID;
+
+        MessageDigest digest;
+
+        Timestamp received;
+
+        // the payload is shared with the consumers instead of being copied
+        std::shared_ptr<std::vector<uint8_t>> payload;
+
+        std::vector<uint32_t> neighbors;
+
+        // connections which delivered the message or to which it has been sent
+        std::set<uint32_t> peers;
+    };
+
+    // compact entry which only remembers that a message has been seen
+    struct SeenEntry {
+        bool occupied = false;
+
+        uint8_t msgType;
+
+        uint32_t senderID;
+
+        MessageDigest digest;
+
+        Timestamp received;
+    };
+
+    PayloadEntry& emplace(ReceivedMessage& msg, Timestamp now);
+
+    // moves the oldest payload entry to the digest tier
+    void demoteOldest();
+
+    void expire(Timestamp now);
+
+    void observeDuplicate(Timestamp received, Timestamp now);
+
     size_t maxCapacity_;
 
-    std::set<uint32_t> emptySet_;
+    size_t maxMemory_;
+
+    size_t usedMemory_;
+
+    // initially derived from the expected flood horizon,
+    // extended if duplicates arrive later than expected
+    std::chrono::milliseconds payloadTTL_;
+
+    std::chrono::milliseconds seenTTL_;
+
+    std::vector<uint32_t> emptyNeighbors_;
+
+    DigestTable<PayloadEntry> payloadTier_;
 
-    std::queue<std::string> FIFOBuffer_;
+    DigestTable<SeenEntry> seenTier_;
 
-    std::unordered_map<std::string, std::pair<ReceivedMessage, std::set<uint32_t>>> indexBuffer_;
+    Statistics statistics_;
 };
 
 
@@ -0,0 +1,78 @@
+#include <cryptopp/filters.h>
+#include <cryptopp/zdeflate.h>
+#include <cryptopp/zinflate.h>
+#include "MessageCompression.h"
+
+namespace {
+    // stops the decompression as soon as the output exceeds the given size
+    class BoundedVectorSink : public CryptoPP::Bufferless<CryptoPP::Sink> {
+    public:
+        BoundedVectorSink(std::vector<uint8_t>& output, size_t maxSize) : output_(output), maxSize_(maxSize) {}
+
+        size_t Put2(const CryptoPP::byte* inString, size_t length, int messageEnd, bool blocking) override {
+            if (length > maxSize_ - output_.size())
+                throw CryptoPP::Exception(CryptoPP::Exception::INVALID_DATA_FORMAT, "decompressed message too long");
+
+            output_.insert(output_.end(), inString, inString + length);
+            return 0;
+        }
+
+    private:
+        std::vector<uint8_t>& output_;
+        size_t maxSize_;
+    };
+}
+
+std::vector<uint8_t> MessageCompression::encode(const std::vector<uint8_t>& message) {
+    std::vector<uint8_t> encodedMessage;
+
+    if ((message.size() >= MIN_COMPRESSION_SIZE) && (message.size() <= MAX_MESSAGE_SIZE)) {
+        encodedMessage.push_back(Deflate);
+        for (int shift = 24; shift >= 0; shift -= 8)
+            encodedMessage.push_back(static_cast<uint8_t>(message.size() >> shift));
+
+        CryptoPP::Deflator deflator(new CryptoPP::VectorSink(encodedMessage), CryptoPP::Deflator::DEFAULT_DEFLATE_LEVEL);
+        deflator.Put(message.data(), message.size());
+        deflator.MessageEnd();
+
+        if (encodedMessage.size() + MIN_SAVINGS <= message.size() + 1)
+            return encodedMessage;
+    }
+
+    // transmit incompressible messages unchanged
+    encodedMessage.clear();
+    encodedMessage.reserve(1 + message.size());
+    encodedMessage.push_back(Raw);
+    encodedMessage.insert(encodedMessage.end(), message.begin(), message.end());
+    return encodedMessage;
+}
+
+int MessageCompression::decode(const std::vector<uint8_t>& encodedMessage, std::vector<uint8_t>& message,
+                               size_t maxSize) {
+    if (encodedMessage.empty())
+        return -1;
+
+    if (encodedMessage[0] == Raw) {
+        message.assign(encodedMessage.begin() + 1, encodedMessage.end());
+        return 0;
+    }
+
+    if ((encodedMessage[0] != Deflate) || (encodedMessage.size() < DEFLATE_HEADER_SIZE))
+        return -1;
+
+    // reject the message before inflating it if the announced length exceeds the budget
+    size_t length = (static_cast<uint32_t>(encodedMessage[1]) << 24) | (encodedMessage[2] << 16) | (encodedMessage[3] << 8) | encodedMessage[4];
+    if (length > maxSize)
+        return -1;
+
+    message.clear();
+    message.reserve(length);
+    try {
+        CryptoPP::Inflator inflator(new BoundedVectorSink(message, length));
+        inflator.Put(encodedMessage.data() + DEFLATE_HEADER_SIZE, encodedMessage.size() - DEFLATE_HEADER_SIZE);
+        inflator.MessageEnd();
+    } catch (const CryptoPP::Exception&) {
+        return -1;
+    }
+    return (message.size() == length) ? 0 : -1;
+}
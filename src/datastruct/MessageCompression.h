@@ -0,0 +1,38 @@
+#ifndef THREEPP_MESSAGECOMPRESSION_H
+#define THREEPP_MESSAGECOMPRESSION_H
+
+#include <cstdint>
+#include <vector>
+
+// Compresses submitted messages with Deflate if it reduces the number of slices.
+// The first byte of an encoded message determines the codec,
+// compressed messages are followed by their uncompressed length (4 bytes) in Big Endian format.
+class MessageCompression {
+public:
+    enum Codec : uint8_t {
+        Raw,
+        Deflate
+    };
+
+    // short messages are not worth compressing
+    static const size_t MIN_COMPRESSION_SIZE = 64;
+
+    // size of a slice in the secured rounds
+    static const size_t MIN_SAVINGS = 31;
+
+    static const size_t DEFLATE_HEADER_SIZE = 5;
+
+    // larger messages are neither compressed nor decompressed
+    static const size_t MAX_MESSAGE_SIZE = 64 * 1024 * 1024;
+
+    // prepends the codec byte and compresses the message if it saves at least one slice
+    static std::vector<uint8_t> encode(const std::vector<uint8_t>& message);
+
+    // returns -1 if the codec is unknown, the data is corrupted
+    // or the decompressed message does not match its announced length of at most maxSize bytes
+    static int decode(const std::vector<uint8_t>& encodedMessage, std::vector<uint8_t>& message,
+                      size_t maxSize = MAX_MESSAGE_SIZE);
+};
+
+
+#endif //THREEPP_MESSAGECOMPRESSION_H
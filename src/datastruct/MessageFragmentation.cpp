@@ -0,0 +1,110 @@
+#include <iostream>
+#include <algorithm>
+#include "MessageFragmentation.h"
+
+MessageFragmentation::MessageFragmentation(size_t maxMemory, size_t maxFragmentSize)
+        : maxMemory_(maxMemory), fragmentDataSize_(maxFragmentSize - FRAGMENT_HEADER_SIZE), usedMemory_(0) {}
+
+std::vector<std::vector<uint8_t>> MessageFragmentation::split(const std::vector<uint8_t>& message,
+                                                              uint64_t messageID, size_t maxFragmentSize) {
+    std::vector<std::vector<uint8_t>> fragments;
+    size_t fragmentDataSize = maxFragmentSize - FRAGMENT_HEADER_SIZE;
+
+    // an empty message is transmitted as a single empty fragment
+    size_t numFragments = std::max<size_t>(1, (message.size() + fragmentDataSize - 1) / fragmentDataSize);
+    if (numFragments > 0xFFFF)
+        return fragments;
+
+    fragments.reserve(numFragments);
+    for (size_t i = 0; i < numFragments; i++) {
+        size_t offset = i * fragmentDataSize;
+        size_t length = std::min(fragmentDataSize, message.size() - offset);
+
+        std::vector<uint8_t> fragment(FRAGMENT_HEADER_SIZE + length);
+        for (uint32_t j = 0; j < 8; j++)
+            fragment[j] = (messageID >> (56 - 8 * j)) & 0xFF;
+        fragment[8] = (i & 0xFF00) >> 8;
+        fragment[9] = (i & 0x00FF);
+        fragment[10] = (numFragments & 0xFF00) >> 8;
+        fragment[11] = (numFragments & 0x00FF);
+        std::copy(message.begin() + offset, message.begin() + offset + length, &fragment[FRAGMENT_HEADER_SIZE]);
+
+        fragments.push_back(std::move(fragment));
+    }
+    return fragments;
+}
+
+bool MessageFragmentation::reassemble(const std::vector<uint8_t>& fragment, std::vector<uint8_t>& message) {
+    if (fragment.size() < FRAGMENT_HEADER_SIZE)
+        return false;
+
+    uint64_t messageID = 0;
+    for (uint32_t j = 0; j < 8; j++)
+        messageID = (messageID << 8) | fragment[j];
+    uint16_t index = (fragment[8] << 8) | fragment[9];
+    uint16_t numFragments = (fragment[10] << 8) | fragment[11];
+    size_t length = fragment.size() - FRAGMENT_HEADER_SIZE;
+
+    // all fragments except the last one carry the maximum amount of data
+    if ((index >= numFragments) || (length > fragmentDataSize_)
+        || ((index < numFragments - 1) && (length != fragmentDataSize_)))
+        return false;
+
+    // deliver unfragmented messages directly
+    if (numFragments == 1) {
+        message.assign(fragment.begin() + FRAGMENT_HEADER_SIZE, fragment.end());
+        return true;
+    }
+
+    auto position = pendingMessages_.find(messageID);
+    if (position == pendingMessages_.end()) {
+        size_t capacity = numFragments * fragmentDataSize_;
+        if (capacity > maxMemory_) {
+            std::cout << "Error: the fragmented message exceeds the reassembly memory" << std::endl;
+            return false;
+        }
+
+        // drop the oldest pending messages until the new message fits
+        while (usedMemory_ + capacity > maxMemory_) {
+            evict(arrivalOrder_.front());
+            arrivalOrder_.pop_front();
+        }
+
+        PendingMessage pending;
+        pending.data.resize(capacity);
+        pending.received.resize(numFragments);
+        usedMemory_ += capacity;
+
+        position = pendingMessages_.emplace(messageID, std::move(pending)).first;
+        arrivalOrder_.push_back(messageID);
+    }
+
+    PendingMessage& pending = position->second;
+    if ((pending.received.size() != numFragments) || pending.received[index])
+        return false;
+
+    std::copy(fragment.begin() + FRAGMENT_HEADER_SIZE, fragment.end(), &pending.data[index * fragmentDataSize_]);
+    pending.received[index] = true;
+    pending.numReceived++;
+
+    // the size of the message is determined by the last fragment
+    if (index == numFragments - 1)
+        pending.data.resize(index * fragmentDataSize_ + length);
+
+    if (pending.numReceived < numFragments)
+        return false;
+
+    message = std::move(pending.data);
+    evict(messageID);
+    arrivalOrder_.erase(std::find(arrivalOrder_.begin(), arrivalOrder_.end(), messageID));
+    return true;
+}
+
+void MessageFragmentation::evict(uint64_t messageID) {
+    auto position = pendingMessages_.find(messageID);
+    if (position == pendingMessages_.end())
+        return;
+
+    usedMemory_ -= position->second.received.size() * fragmentDataSize_;
+    pendingMessages_.erase(position);
+}
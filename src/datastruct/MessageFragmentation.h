@@ -0,0 +1,60 @@
+#ifndef THREEPP_MESSAGEFRAGMENTATION_H
+#define THREEPP_MESSAGEFRAGMENTATION_H
+
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+
+#include "MessageBatch.h"
+
+// Splits messages, which exceed the size of a slot, into fragments transmitted in separate slots.
+// Each fragment is preceded by the random message ID (8 bytes), the index of the fragment (2 bytes)
+// and the number of fragments (2 bytes) in Big Endian format.
+class MessageFragmentation {
+public:
+    static const size_t FRAGMENT_HEADER_SIZE = 12;
+
+    // the fragments also fit into a batch
+    static const size_t MAX_FRAGMENT_SIZE = MessageBatch::MAX_PAYLOAD_SIZE - MessageBatch::FRAME_HEADER_SIZE;
+
+    static const size_t MAX_FRAGMENT_DATA_SIZE = MAX_FRAGMENT_SIZE - FRAGMENT_HEADER_SIZE;
+
+    // the pending messages are limited to the given memory, the oldest message is dropped first,
+    // the maximum fragment size has to match the one of the sender
+    MessageFragmentation(size_t maxMemory = 64 * 1024 * 1024, size_t maxFragmentSize = MAX_FRAGMENT_SIZE);
+
+    // returns an empty vector if the message requires more than 2^16 - 1 fragments
+    static std::vector<std::vector<uint8_t>> split(const std::vector<uint8_t>& message, uint64_t messageID,
+                                                   size_t maxFragmentSize = MAX_FRAGMENT_SIZE);
+
+    // returns true and the reassembled message if the fragment completes its message
+    bool reassemble(const std::vector<uint8_t>& fragment, std::vector<uint8_t>& message);
+
+private:
+    struct PendingMessage {
+        // the data of fragment i is stored at offset i * fragmentDataSize_
+        std::vector<uint8_t> data;
+
+        std::vector<bool> received;
+
+        uint16_t numReceived = 0;
+    };
+
+    void evict(uint64_t messageID);
+
+    size_t maxMemory_;
+
+    // amount of data carried by all fragments except the last one
+    size_t fragmentDataSize_;
+
+    size_t usedMemory_;
+
+    std::unordered_map<uint64_t, PendingMessage> pendingMessages_;
+
+    // IDs of the pending messages in the order of their first fragment
+    std::deque<uint64_t> arrivalOrder_;
+};
+
+
+#endif //THREEPP_MESSAGEFRAGMENTATION_H
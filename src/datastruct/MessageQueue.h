@@ -5,6 +5,7 @@
 #include <queue>
 #include <mutex>
 #include <condition_variable>
+#include <chrono>
 #include <iostream>
 
 
@@ -31,6 +32,17 @@ public:
         return msg;
     }
 
+    // waits until the deadline for a message, returns false if no message has arrived
+    bool pop(T& msg, std::chrono::steady_clock::time_point deadline) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!cond_var_.wait_until(lock, deadline, [&]() { return !msg_queue_.empty(); }))
+            return false;
+
+        msg = msg_queue_.front();
+        msg_queue_.pop();
+        return true;
+    }
+
     bool empty() {
         std::lock_guard<std::mutex> lock(mutex_);
         return msg_queue_.empty();
@@ -10,17 +10,25 @@ enum MessageType {
     // DC-Network messages
     DCConnect,
     DCConnectResponse,
+    // exchanged by the members after the group has been (re)formed
+    GroupSynchronization,
 
     InitialRoundCommitments,
+    InitialRoundCommitmentDigest,
     InitialRoundFirstSharing,
     InitialRoundSecondSharing,
     InvalidShare,
     InitialRoundFinished,
 
     FinalRoundCommitments,
+    FinalRoundCommitmentDigest,
     FinalRoundFirstSharing,
     FinalRoundSecondSharing,
     FinalRoundFinished,
+    HybridPayloadSharing,
+    HybridPayloadVerdict,
+    // envelope which tags a message of a pipelined secured round with the round's epoch
+    RoundMessage,
 
     DCNetworkReceived,
 
@@ -44,6 +52,8 @@ enum MessageType {
 
     // Flood and Prune
     FloodAndPrune,
+    FloodAndPruneAnnouncement,
+    FloodAndPruneRequest,
 
     // Evaluation
     DCNetworkLogging,
@@ -1,6 +1,7 @@
 #ifndef THREEPP_NETWORKMESSAGE_H
 #define THREEPP_NETWORKMESSAGE_H
 
+#include <cstdint>
 #include <vector>
 #include <array>
 
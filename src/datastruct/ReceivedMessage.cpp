@@ -1,17 +1,19 @@
 #include "ReceivedMessage.h"
+#include "../utils/Utils.h"
 
-ReceivedMessage::ReceivedMessage() : connectionID_(0), timestamp_(std::chrono::system_clock::now()) {}
+ReceivedMessage::ReceivedMessage() : connectionID_(0), timestamp_(std::chrono::system_clock::now()), digestValid_(false) {}
 
-ReceivedMessage::ReceivedMessage(uint8_t msgType) : NetworkMessage(msgType), connectionID_(0) {}
+ReceivedMessage::ReceivedMessage(uint8_t msgType) : NetworkMessage(msgType), connectionID_(0), digestValid_(false) {}
 
-ReceivedMessage::ReceivedMessage(uint32_t connectionID) : connectionID_(connectionID) {}
+ReceivedMessage::ReceivedMessage(uint32_t connectionID) : connectionID_(connectionID), digestValid_(false) {}
 
 ReceivedMessage::ReceivedMessage(uint32_t connectionID, uint8_t msgType, uint32_t senderID, std::vector<uint8_t> body)
-: NetworkMessage(msgType, senderID, std::move(body)), connectionID_(connectionID) {}
+: NetworkMessage(msgType, senderID, std::move(body)), connectionID_(connectionID), digestValid_(false) {}
 
 void ReceivedMessage::resizeBody() {
     uint32_t body_size = (header_[1] << 16) | (header_[2] << 8) | header_[3];
     body_.resize(body_size);
+    digestValid_ = false;
 }
 
 uint8_t ReceivedMessage::msgType() {
@@ -32,4 +34,12 @@ Timestamp ReceivedMessage::timestamp() {
 
 void ReceivedMessage::updateMsgType(uint8_t msgType) {
     header_[0] = msgType;
+}
+
+const MessageDigest& ReceivedMessage::digest() {
+    if(!digestValid_) {
+        digest_ = utils::sha256Digest(body_);
+        digestValid_ = true;
+    }
+    return digest_;
 }
\ No newline at end of file
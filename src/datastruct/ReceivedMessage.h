@@ -6,6 +6,8 @@
 
 typedef std::chrono::system_clock::time_point Timestamp;
 
+typedef std::array<uint8_t, 32> MessageDigest;
+
 class ReceivedMessage : public NetworkMessage {
 public:
     ReceivedMessage();
@@ -27,10 +29,17 @@ public:
     Timestamp timestamp();
 
     void updateMsgType(uint8_t msgType);
+
+    // SHA-256 hash of the body, computed on the first call and cached afterwards
+    const MessageDigest& digest();
 private:
     uint32_t connectionID_;
 
     Timestamp timestamp_;
+
+    bool digestValid_;
+
+    MessageDigest digest_;
 };
 
 
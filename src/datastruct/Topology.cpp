@@ -0,0 +1,311 @@
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <random>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "Topology.h"
+
+// header of the binary format: magic, number of nodes and number of adjacency entries,
+// followed by the offsets (uint64_t) and the adjacency array (uint32_t) in host byte order
+const char TOPOLOGY_MAGIC[4] = {'3', 'P', 'P', 'T'};
+const size_t TOPOLOGY_HEADER_SIZE = 16;
+
+// consecutive failed pairings after which the random regular generator starts over
+const size_t MAX_PAIRING_FAILURES = 1000;
+
+struct Topology::Storage {
+    std::vector<uint64_t> offsets;
+
+    std::vector<uint32_t> adjacency;
+};
+
+namespace {
+    // std::uniform_int_distribution is implementation defined,
+    // so the generators draw their numbers from the raw Mersenne Twister output
+    uint64_t uniform(std::mt19937_64& rng, uint64_t bound) {
+        uint64_t threshold = (0 - bound) % bound;
+        for (;;) {
+            uint64_t r = rng();
+            if (r >= threshold)
+                return r % bound;
+        }
+    }
+
+    double uniformReal(std::mt19937_64& rng) {
+        return (rng() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    bool connected(const std::vector<uint32_t>& neighbors, uint32_t node) {
+        return std::find(neighbors.begin(), neighbors.end(), node) != neighbors.end();
+    }
+
+    void disconnect(std::vector<uint32_t>& neighbors, uint32_t node) {
+        neighbors.erase(std::find(neighbors.begin(), neighbors.end(), node));
+    }
+}
+
+Topology::Topology() : numNodes_(0), offsets_(nullptr), adjacency_(nullptr) {
+    std::shared_ptr<Storage> storage = std::make_shared<Storage>();
+    storage->offsets.push_back(0);
+    assign(storage, 0, storage->offsets.data(), storage->adjacency.data());
+}
+
+Topology::Topology(const std::vector<std::vector<uint32_t>>& adjacencyLists) {
+    std::shared_ptr<Storage> storage = std::make_shared<Storage>();
+    storage->offsets.reserve(adjacencyLists.size() + 1);
+
+    size_t numEdges = 0;
+    for (auto& neighbors : adjacencyLists)
+        numEdges += neighbors.size();
+    storage->adjacency.reserve(numEdges);
+
+    storage->offsets.push_back(0);
+    for (auto& neighbors : adjacencyLists) {
+        storage->adjacency.insert(storage->adjacency.end(), neighbors.begin(), neighbors.end());
+        storage->offsets.push_back(storage->adjacency.size());
+    }
+    assign(storage, adjacencyLists.size(), storage->offsets.data(), storage->adjacency.data());
+}
+
+void Topology::assign(std::shared_ptr<void> storage, uint32_t numNodes, const uint64_t* offsets,
+                      const uint32_t* adjacency) {
+    storage_ = std::move(storage);
+    numNodes_ = numNodes;
+    offsets_ = offsets;
+    adjacency_ = adjacency;
+}
+
+Topology Topology::fromCSV(const std::string& fileName) {
+    std::ifstream in(fileName);
+    if (!in.is_open()) {
+        std::cerr << "Error: could not open the topology file " << fileName << std::endl;
+        return Topology();
+    }
+
+    std::vector<std::vector<uint32_t>> adjacencyLists;
+    std::string line;
+    while (getline(in, line)) {
+        const char* position = line.c_str();
+        char* end;
+
+        uint32_t node = std::strtoul(position, &end, 10);
+        if (end == position)
+            continue;
+
+        if (node >= adjacencyLists.size())
+            adjacencyLists.resize(node + 1);
+
+        for (position = end; *position != '\0'; position = end) {
+            // skip the separators
+            if ((*position < '0') || (*position > '9')) {
+                end = const_cast<char*>(position + 1);
+                continue;
+            }
+            adjacencyLists[node].push_back(std::strtoul(position, &end, 10));
+        }
+    }
+    return Topology(adjacencyLists);
+}
+
+Topology Topology::fromBinary(const std::string& fileName) {
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: could not open the topology file " << fileName << std::endl;
+        return Topology();
+    }
+
+    struct stat fileStat;
+    if ((fstat(fd, &fileStat) < 0) || (static_cast<size_t>(fileStat.st_size) < TOPOLOGY_HEADER_SIZE)) {
+        std::cerr << "Error: invalid topology file " << fileName << std::endl;
+        close(fd);
+        return Topology();
+    }
+
+    size_t fileSize = fileStat.st_size;
+    void* mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Error: could not map the topology file " << fileName << std::endl;
+        return Topology();
+    }
+    std::shared_ptr<void> storage(mapping, [fileSize](void* p) { munmap(p, fileSize); });
+
+    const uint8_t* data = static_cast<const uint8_t*>(mapping);
+    uint32_t numNodes;
+    uint64_t numEdges;
+    std::memcpy(&numNodes, data + 4, sizeof(numNodes));
+    std::memcpy(&numEdges, data + 8, sizeof(numEdges));
+
+    // the sizes are checked against the file size before they are multiplied to avoid an overflow
+    uint64_t payloadSize = fileSize - TOPOLOGY_HEADER_SIZE;
+    uint64_t numOffsets = static_cast<uint64_t>(numNodes) + 1;
+    bool valid = (std::memcmp(data, TOPOLOGY_MAGIC, sizeof(TOPOLOGY_MAGIC)) == 0)
+                 && (numOffsets <= payloadSize / sizeof(uint64_t)) && (numEdges <= payloadSize / sizeof(uint32_t))
+                 && (payloadSize == numOffsets * sizeof(uint64_t) + numEdges * sizeof(uint32_t));
+    if (!valid) {
+        std::cerr << "Error: invalid topology file " << fileName << std::endl;
+        return Topology();
+    }
+
+    const uint64_t* offsets = reinterpret_cast<const uint64_t*>(data + TOPOLOGY_HEADER_SIZE);
+    const uint32_t* adjacency = reinterpret_cast<const uint32_t*>(offsets + numOffsets);
+
+    // the adjacency lists have to be consecutive and cover all edges
+    valid = (offsets[0] == 0) && (offsets[numNodes] == numEdges);
+    for (uint32_t node = 0; valid && (node < numNodes); node++)
+        valid = offsets[node] <= offsets[node + 1];
+    for (uint64_t edge = 0; valid && (edge < numEdges); edge++)
+        valid = adjacency[edge] < numNodes;
+    if (!valid) {
+        std::cerr << "Error: inconsistent adjacency lists in the topology file " << fileName << std::endl;
+        return Topology();
+    }
+
+    Topology topology;
+    topology.assign(std::move(storage), numNodes, offsets, adjacency);
+    return topology;
+}
+
+Topology Topology::load(const std::string& fileName) {
+    if ((fileName.size() >= 4) && (fileName.compare(fileName.size() - 4, 4, ".bin") == 0))
+        return fromBinary(fileName);
+    else
+        return fromCSV(fileName);
+}
+
+int Topology::writeBinary(const std::string& fileName) {
+    std::ofstream out(fileName, std::ios::binary);
+    if (!out.is_open())
+        return -1;
+
+    uint32_t numNodes = numNodes_;
+    uint64_t numEdges = offsets_[numNodes_];
+    out.write(TOPOLOGY_MAGIC, sizeof(TOPOLOGY_MAGIC));
+    out.write(reinterpret_cast<const char*>(&numNodes), sizeof(numNodes));
+    out.write(reinterpret_cast<const char*>(&numEdges), sizeof(numEdges));
+    out.write(reinterpret_cast<const char*>(offsets_), (numNodes_ + 1) * sizeof(uint64_t));
+    out.write(reinterpret_cast<const char*>(adjacency_), numEdges * sizeof(uint32_t));
+
+    return out.good() ? 0 : -1;
+}
+
+Topology Topology::randomRegular(uint32_t numNodes, uint32_t degree, uint64_t seed) {
+    if ((degree >= numNodes) || ((static_cast<uint64_t>(numNodes) * degree) % 2 != 0)) {
+        std::cerr << "Error: no " << degree << "-regular graph with " << numNodes << " nodes exists" << std::endl;
+        return Topology();
+    }
+
+    std::mt19937_64 rng(seed);
+    std::vector<std::vector<uint32_t>> adjacencyLists(numNodes);
+    std::vector<uint32_t> stubs;
+
+    // pair the stubs randomly and reject self loops and multi-edges,
+    // start over if the remaining stubs cannot be paired
+    for (bool complete = false; !complete;) {
+        for (auto& neighbors : adjacencyLists) {
+            neighbors.clear();
+            neighbors.reserve(degree);
+        }
+        stubs.resize(static_cast<size_t>(numNodes) * degree);
+        for (size_t i = 0; i < stubs.size(); i++)
+            stubs[i] = i / degree;
+
+        size_t failures = 0;
+        while (!stubs.empty() && (failures < MAX_PAIRING_FAILURES)) {
+            size_t i = uniform(rng, stubs.size());
+            size_t j = uniform(rng, stubs.size() - 1);
+            if (j >= i)
+                j++;
+
+            uint32_t u = stubs[i];
+            uint32_t v = stubs[j];
+            if ((u == v) || connected(adjacencyLists[u], v)) {
+                failures++;
+                continue;
+            }
+            failures = 0;
+            adjacencyLists[u].push_back(v);
+            adjacencyLists[v].push_back(u);
+
+            // remove both stubs, the higher index first
+            stubs[std::max(i, j)] = stubs.back();
+            stubs.pop_back();
+            stubs[std::min(i, j)] = stubs.back();
+            stubs.pop_back();
+        }
+        complete = stubs.empty();
+    }
+
+    for (auto& neighbors : adjacencyLists)
+        std::sort(neighbors.begin(), neighbors.end());
+
+    return Topology(adjacencyLists);
+}
+
+Topology Topology::smallWorld(uint32_t numNodes, uint32_t degree, double rewiringProbability, uint64_t seed) {
+    if ((degree >= numNodes) || (degree % 2 != 0)) {
+        std::cerr << "Error: the degree of a small-world graph has to be even and smaller than the number of nodes"
+                  << std::endl;
+        return Topology();
+    }
+
+    std::mt19937_64 rng(seed);
+    std::vector<std::vector<uint32_t>> adjacencyLists(numNodes);
+
+    // ring lattice
+    for (uint32_t u = 0; u < numNodes; u++) {
+        for (uint32_t j = 1; j <= degree / 2; j++) {
+            uint32_t v = (u + j) % numNodes;
+            adjacencyLists[u].push_back(v);
+            adjacencyLists[v].push_back(u);
+        }
+    }
+
+    // rewire the edges (u, u+j) to uniformly chosen nodes
+    for (uint32_t j = 1; j <= degree / 2; j++) {
+        for (uint32_t u = 0; u < numNodes; u++) {
+            if (uniformReal(rng) >= rewiringProbability)
+                continue;
+
+            uint32_t v = (u + j) % numNodes;
+            if (!connected(adjacencyLists[u], v) || (adjacencyLists[u].size() >= numNodes - 1))
+                continue;
+
+            uint32_t w;
+            do {
+                w = uniform(rng, numNodes);
+            } while ((w == u) || connected(adjacencyLists[u], w));
+
+            disconnect(adjacencyLists[u], v);
+            disconnect(adjacencyLists[v], u);
+            adjacencyLists[u].push_back(w);
+            adjacencyLists[w].push_back(u);
+        }
+    }
+
+    for (auto& neighbors : adjacencyLists)
+        std::sort(neighbors.begin(), neighbors.end());
+
+    return Topology(adjacencyLists);
+}
+
+uint32_t Topology::size() const {
+    return numNodes_;
+}
+
+size_t Topology::numEdges() const {
+    return offsets_[numNodes_] / 2;
+}
+
+Topology::Neighbors Topology::neighbors(uint32_t node) const {
+    return Neighbors(adjacency_ + offsets_[node], adjacency_ + offsets_[node + 1]);
+}
+
+Topology::Neighbors Topology::operator[](uint32_t node) const {
+    return neighbors(node);
+}
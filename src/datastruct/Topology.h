@@ -0,0 +1,80 @@
+#ifndef THREEPP_TOPOLOGY_H
+#define THREEPP_TOPOLOGY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+
+// Undirected graph in compressed sparse row format.
+// The neighbors of node i are stored in adjacency[offsets[i]] ... adjacency[offsets[i+1] - 1].
+class Topology {
+public:
+    // contiguous view on the neighbors of a node
+    class Neighbors {
+    public:
+        Neighbors(const uint32_t* begin, const uint32_t* end) : begin_(begin), end_(end) {}
+
+        const uint32_t* begin() const { return begin_; }
+
+        const uint32_t* end() const { return end_; }
+
+        size_t size() const { return end_ - begin_; }
+
+        uint32_t operator[](size_t index) const { return begin_[index]; }
+
+    private:
+        const uint32_t* begin_;
+
+        const uint32_t* end_;
+    };
+
+    Topology();
+
+    // builds the CSR arrays from adjacency lists
+    Topology(const std::vector<std::vector<uint32_t>>& adjacencyLists);
+
+    // loads a topology in the format of the sample_topologies,
+    // each line contains the node ID followed by the IDs of its neighbors
+    static Topology fromCSV(const std::string& fileName);
+
+    // maps a topology written by writeBinary into memory
+    static Topology fromBinary(const std::string& fileName);
+
+    // selects the loader based on the file extension (.bin or .csv)
+    static Topology load(const std::string& fileName);
+
+    int writeBinary(const std::string& fileName);
+
+    // random d-regular graph, generated deterministically from the seed
+    static Topology randomRegular(uint32_t numNodes, uint32_t degree, uint64_t seed);
+
+    // Watts-Strogatz graph: a ring lattice in which each node is connected to its degree nearest nodes,
+    // every edge is rewired with the given probability
+    static Topology smallWorld(uint32_t numNodes, uint32_t degree, double rewiringProbability, uint64_t seed);
+
+    uint32_t size() const;
+
+    size_t numEdges() const;
+
+    Neighbors neighbors(uint32_t node) const;
+
+    Neighbors operator[](uint32_t node) const;
+
+private:
+    struct Storage;
+
+    void assign(std::shared_ptr<void> storage, uint32_t numNodes, const uint64_t* offsets, const uint32_t* adjacency);
+
+    uint32_t numNodes_;
+
+    const uint64_t* offsets_;
+
+    const uint32_t* adjacency_;
+
+    // either owns the arrays or the memory mapping of a binary file
+    std::shared_ptr<void> storage_;
+};
+
+
+#endif //THREEPP_TOPOLOGY_H
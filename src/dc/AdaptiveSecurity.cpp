@@ -0,0 +1,60 @@
+#include <iostream>
+#include "AdaptiveSecurity.h"
+
+AdaptiveSecurity::AdaptiveSecurity(uint32_t stepDownRounds)
+        : level_(AdaptiveUnsecured), stepDownRounds_(stepDownRounds), cleanRounds_(0), rounds_(0) {}
+
+AdaptiveLevel AdaptiveSecurity::level() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return level_;
+}
+
+void AdaptiveSecurity::escalate(AdaptiveLevel level, const std::string& reason) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cleanRounds_ = 0;
+    if (level > level_)
+        transition(level, reason);
+}
+
+void AdaptiveSecurity::cleanRound() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rounds_++;
+    if (level_ == AdaptiveUnsecured)
+        return;
+
+    cleanRounds_++;
+    if (cleanRounds_ >= stepDownRounds_) {
+        cleanRounds_ = 0;
+        transition(static_cast<AdaptiveLevel>(level_ - 1), std::to_string(stepDownRounds_) + " clean rounds");
+    }
+}
+
+void AdaptiveSecurity::stepDownRounds(uint32_t stepDownRounds) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stepDownRounds_ = stepDownRounds;
+}
+
+std::vector<Escalation> AdaptiveSecurity::history() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return history_;
+}
+
+const char* AdaptiveSecurity::levelName(AdaptiveLevel level) {
+    switch (level) {
+        case AdaptiveUnsecured:
+            return "unsecured";
+        case AdaptiveSecured:
+            return "secured";
+        case AdaptiveValidated:
+            return "validated";
+    }
+    return "unknown";
+}
+
+void AdaptiveSecurity::transition(AdaptiveLevel level, const std::string& reason) {
+    std::cout << "Adaptive security level: " << levelName(level_) << " -> " << levelName(level)
+              << " (" << reason << ")" << std::endl;
+
+    history_.push_back({rounds_, std::chrono::system_clock::now(), level_, level, reason});
+    level_ = level;
+}
@@ -0,0 +1,74 @@
+#ifndef THREEPP_ADAPTIVESECURITY_H
+#define THREEPP_ADAPTIVESECURITY_H
+
+#include <cstdint>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// number of clean rounds after which the adaptive security level is lowered by one step
+const uint32_t ADAPTIVE_STEP_DOWN_ROUNDS = 10;
+
+enum AdaptiveLevel {
+    // XOR based unsecured rounds
+    AdaptiveUnsecured,
+    // secured rounds, the commitments are validated only if the protocol requires it
+    AdaptiveSecured,
+    // secured rounds with the validation of all commitments
+    AdaptiveValidated
+};
+
+struct Escalation {
+    // number of completed rounds at the time of the transition
+    uint64_t round;
+
+    std::chrono::system_clock::time_point time;
+
+    AdaptiveLevel from;
+
+    AdaptiveLevel to;
+
+    std::string reason;
+};
+
+// Escalation engine of the Adaptive security level.
+// The DC network starts with the unsecured rounds and escalates on CRC errors and blame evidence,
+// after a number of clean rounds the level is lowered step by step.
+class AdaptiveSecurity {
+public:
+    AdaptiveSecurity(uint32_t stepDownRounds = ADAPTIVE_STEP_DOWN_ROUNDS);
+
+    AdaptiveLevel level();
+
+    // raises the level, a lower or equal level only resets the number of clean rounds
+    void escalate(AdaptiveLevel level, const std::string& reason);
+
+    // counts a round without CRC errors and blame messages
+    void cleanRound();
+
+    void stepDownRounds(uint32_t stepDownRounds);
+
+    // copy of all level transitions
+    std::vector<Escalation> history();
+
+    static const char* levelName(AdaptiveLevel level);
+
+private:
+    void transition(AdaptiveLevel level, const std::string& reason);
+
+    std::mutex mutex_;
+
+    AdaptiveLevel level_;
+
+    uint32_t stepDownRounds_;
+
+    uint32_t cleanRounds_;
+
+    uint64_t rounds_;
+
+    std::vector<Escalation> history_;
+};
+
+
+#endif //THREEPP_ADAPTIVESECURITY_H
@@ -0,0 +1,82 @@
+#include <cryptopp/oids.h>
+#include "AsyncVerifier.h"
+
+AsyncVerifier::AsyncVerifier(uint32_t numThreads)
+        : submitted_(0), watermark_(0), failed_(false), stopped_(false) {
+    for (uint32_t t = 0; t < numThreads; t++)
+        workers_.push_back(std::thread(&AsyncVerifier::work, this));
+}
+
+AsyncVerifier::~AsyncVerifier() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+    }
+    taskAvailable_.notify_all();
+
+    for (auto &t : workers_)
+        t.join();
+}
+
+void AsyncVerifier::submit(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push(std::pair(submitted_, std::move(task)));
+        submitted_++;
+        finished_.push_back(false);
+    }
+    taskAvailable_.notify_one();
+}
+
+bool AsyncVerifier::wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    taskFinished_.wait(lock, [&]() {
+        return failed_ || (watermark_ == submitted_);
+    });
+    return !failed_;
+}
+
+uint64_t AsyncVerifier::watermark() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return watermark_;
+}
+
+bool AsyncVerifier::failed() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return failed_;
+}
+
+void AsyncVerifier::work() {
+    CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP> threadCurve;
+    threadCurve.Initialize(CryptoPP::ASN1::secp256k1());
+
+    for (;;) {
+        std::pair<uint64_t, Task> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            taskAvailable_.wait(lock, [&]() {
+                return stopped_ || !tasks_.empty();
+            });
+            if (stopped_)
+                return;
+
+            task = std::move(tasks_.front());
+            tasks_.pop();
+        }
+
+        // the remaining tasks are skipped after the first invalid share
+        bool valid = failed() || task.second(threadCurve);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!valid)
+            failed_ = true;
+
+        // advance the watermark over all consecutively finished tasks
+        finished_[task.first - watermark_] = true;
+        while (!finished_.empty() && finished_.front()) {
+            finished_.pop_front();
+            watermark_++;
+        }
+        taskFinished_.notify_all();
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef THREEPP_ASYNCVERIFIER_H
+#define THREEPP_ASYNCVERIFIER_H
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <deque>
+#include <queue>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <cryptopp/eccrypto.h>
+
+// Worker set which verifies the received shares while the round proceeds with the sharing.
+// The watermark counts the tasks which have been verified without a gap in the order of their submission.
+class AsyncVerifier {
+public:
+    // a task returns false if it has detected an invalid share
+    typedef std::function<bool(CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>&)> Task;
+
+    AsyncVerifier(uint32_t numThreads);
+
+    // discards the pending tasks and waits for the running ones
+    ~AsyncVerifier();
+
+    void submit(Task task);
+
+    // blocks until all submitted tasks have been verified or a task has failed,
+    // returns false in the latter case
+    bool wait();
+
+    uint64_t watermark();
+
+    bool failed();
+
+private:
+    void work();
+
+    std::mutex mutex_;
+
+    std::condition_variable taskAvailable_;
+
+    std::condition_variable taskFinished_;
+
+    std::queue<std::pair<uint64_t, Task>> tasks_;
+
+    uint64_t submitted_;
+
+    uint64_t watermark_;
+
+    // completion flags of the tasks above the watermark
+    std::deque<bool> finished_;
+
+    bool failed_;
+
+    bool stopped_;
+
+    std::list<std::thread> workers_;
+};
+
+
+#endif //THREEPP_ASYNCVERIFIER_H
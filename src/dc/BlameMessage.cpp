@@ -0,0 +1,72 @@
+#include "BlameMessage.h"
+#include "DCNetwork.h"
+#include "InitState.h"
+#include "../datastruct/MessageType.h"
+
+std::vector<uint8_t> BlameMessage::encode(uint32_t suspectID, uint32_t slot, uint32_t slice, const CryptoPP::Integer& r,
+                                          const std::vector<CryptoPP::Integer>& slices) {
+    std::vector<uint8_t> messageBody(HEADER_SIZE + 32 + 32 * slices.size());
+    // set the suspect's ID
+    messageBody[0] = (suspectID & 0xFF000000) >> 24;
+    messageBody[1] = (suspectID & 0x00FF0000) >> 16;
+    messageBody[2] = (suspectID & 0x0000FF00) >> 8;
+    messageBody[3] = (suspectID & 0x000000FF);
+
+    // set the index of the slot
+    messageBody[4] = (slot & 0xFF000000) >> 24;
+    messageBody[5] = (slot & 0x00FF0000) >> 16;
+    messageBody[6] = (slot & 0x0000FF00) >> 8;
+    messageBody[7] = (slot & 0x000000FF);
+
+    // set the index of the slice
+    messageBody[8] = (slice & 0xFF000000) >> 24;
+    messageBody[9] = (slice & 0x00FF0000) >> 16;
+    messageBody[10] = (slice & 0x0000FF00) >> 8;
+    messageBody[11] = (slice & 0x000000FF);
+
+    // store the corrupt share
+    r.Encode(&messageBody[HEADER_SIZE], 32);
+    for (uint32_t i = 0, offset = HEADER_SIZE + 32; i < slices.size(); i++, offset += 32)
+        slices[i].Encode(&messageBody[offset], 32);
+
+    return messageBody;
+}
+
+int BlameMessage::decode(const std::vector<uint8_t>& body, Accusation& accusation) {
+    if (body.size() < MIN_SIZE)
+        return -1;
+
+    accusation.suspectID = (body[0] << 24) | (body[1] << 16) | (body[2] << 8) | body[3];
+    accusation.slot = (body[4] << 24) | (body[5] << 16) | (body[6] << 8) | body[7];
+    accusation.slice = (body[8] << 24) | (body[9] << 16) | (body[10] << 8) | body[11];
+
+    accusation.r = CryptoPP::Integer(&body[HEADER_SIZE], 32);
+    accusation.slices.clear();
+    accusation.slices.reserve((body.size() - HEADER_SIZE - 32) / 32);
+    for (size_t offset = HEADER_SIZE + 32; offset + 32 <= body.size(); offset += 32)
+        accusation.slices.push_back(CryptoPP::Integer(&body[offset], 32));
+
+    return 0;
+}
+
+void BlameMessage::broadcast(DCNetwork& DCNet, uint64_t epoch, uint32_t suspectID, const std::vector<uint8_t>& body) {
+    for (auto &member : DCNet.members()) {
+        if (member.second.connectionID() != SELF) {
+            OutgoingMessage blameMessage(member.second.connectionID(), InvalidShare, DCNet.nodeID(), body);
+            DCNet.send(std::move(blameMessage), epoch);
+        }
+    }
+
+    // the other members convict the suspect after validating the blame message
+    if (DCNet.fastRecovery())
+        DCNet.excludeMember(suspectID);
+}
+
+void BlameMessage::collect(DCNetwork& DCNet, uint64_t epoch, const std::function<void(ReceivedMessage&)>& handler) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(BLAME_COLLECTION_TIME);
+    ReceivedMessage message;
+    while (DCNet.inbox(epoch).pop(message, deadline)) {
+        if (message.msgType() == InvalidShare)
+            handler(message);
+    }
+}
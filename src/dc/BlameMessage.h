@@ -0,0 +1,44 @@
+#ifndef THREEPP_BLAMEMESSAGE_H
+#define THREEPP_BLAMEMESSAGE_H
+
+#include <functional>
+#include <vector>
+#include <cryptopp/integer.h>
+#include "../datastruct/ReceivedMessage.h"
+
+class DCNetwork;
+
+// Blame messages of the secured rounds, which disclose a share that does not match its commitment.
+// Layout: suspectID (4) | slot (4) | slice (4) | r (32) | s (32),
+// for a vector commitment the slice index is zero and all slices of the share follow r.
+namespace BlameMessage {
+    const size_t HEADER_SIZE = 12;
+
+    // size of a blame message for a single slice
+    const size_t MIN_SIZE = HEADER_SIZE + 64;
+
+    struct Accusation {
+        uint32_t suspectID;
+        uint32_t slot;
+        uint32_t slice;
+        CryptoPP::Integer r;
+        // the disclosed slice or all slices of a share committed to with a vector commitment
+        std::vector<CryptoPP::Integer> slices;
+    };
+
+    std::vector<uint8_t> encode(uint32_t suspectID, uint32_t slot, uint32_t slice, const CryptoPP::Integer& r,
+                                const std::vector<CryptoPP::Integer>& slices);
+
+    // returns -1 if the message is too short
+    int decode(const std::vector<uint8_t>& body, Accusation& accusation);
+
+    // sends the blame message to all other members,
+    // in the fast recovery mode the suspect is excluded right away
+    void broadcast(DCNetwork& DCNet, uint64_t epoch, uint32_t suspectID, const std::vector<uint8_t>& body);
+
+    // passes the blame messages, which arrive within the collection time, to the handler
+    void collect(DCNetwork& DCNet, uint64_t epoch, const std::function<void(ReceivedMessage&)>& handler);
+};
+
+
+#endif //THREEPP_BLAMEMESSAGE_H
@@ -3,9 +3,10 @@
 #include "FairnessProtocol.h"
 #include "InitState.h"
 #include "../datastruct/MessageType.h"
+#include "SeededShares.h"
 
-BlameRound::BlameRound(DCNetwork &DCNet, std::unordered_map<uint32_t, std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>>> oldCommitments)
-: DCNetwork_(DCNet), k_(DCNetwork_.k()), slotIndex_(-1) {
+BlameRound::BlameRound(DCNetwork &DCNet, std::vector<std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>>> oldCommitments)
+: DCNetwork_(DCNet), k_(DCNetwork_.k()), slotIndex_(-1), oldCommitments_(std::move(oldCommitments)) {
 
     curve_.Initialize(CryptoPP::ASN1::secp256k1());
 
@@ -15,9 +16,9 @@ BlameRound::BlameRound(DCNetwork &DCNet, std::unordered_map<uint32_t, std::vecto
 }
 
 BlameRound::BlameRound(DCNetwork &DCNet, int slotIndex, uint16_t sliceIndex, uint32_t suspiciousMember, CryptoPP::Integer seedPrivateKey,
-                       std::unordered_map<uint32_t, std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>>> oldCommitments)
+                       std::vector<std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>>> oldCommitments)
         : DCNetwork_(DCNet), k_(DCNetwork_.k()), slotIndex_(slotIndex), sliceIndex_(sliceIndex), suspiciousMember_(suspiciousMember),
-          seedPrivateKey_(seedPrivateKey), oldCommitments_(oldCommitments) {
+          seedPrivateKey_(seedPrivateKey), oldCommitments_(std::move(oldCommitments)) {
 
     curve_.Initialize(CryptoPP::ASN1::secp256k1());
 
@@ -30,6 +31,9 @@ BlameRound::~BlameRound() {}
 
 
 std::unique_ptr<DCState> BlameRound::executeTask() {
+    if (DCNetwork_.securityLevel() == Adaptive)
+        DCNetwork_.adaptiveSecurity().escalate(AdaptiveValidated, "blame round");
+
     size_t slotSize = 44;
     size_t numSlices = 2;
 
@@ -168,27 +172,46 @@ std::unique_ptr<DCState> BlameRound::executeTask() {
                 // slice
                 uint32_t sliceIndex = (finalMessageVector[slot][10] << 8) | finalMessageVector[slot][11];
 
-                CryptoPP::Integer sharedSecret = curve_.GetCurve().ScalarMultiply(DCNetwork_.members().find(memberID)->second.publicKey(), r).x;
+                // the accusation has to refer to a commitment of the suspect in the disrupted round
+                auto suspect = DCNetwork_.members().find(memberID);
+                uint32_t memberIndex = std::distance(DCNetwork_.members().begin(), suspect);
+                if ((suspect == DCNetwork_.members().end()) || (memberIndex >= oldCommitments_.size())
+                    || (slotIndex >= oldCommitments_[memberIndex].size())
+                    || (oldCommitments_[memberIndex][slotIndex].size() < k_)
+                    || (sliceIndex >= oldCommitments_[memberIndex][slotIndex][0].size())) {
+                    nonEmptySlots++;
+                    continue;
+                }
+
+                CryptoPP::Integer sharedSecret = curve_.GetCurve().ScalarMultiply(suspect->second.publicKey(), r).x;
 
                 std::array<uint8_t, 32> seed;
                 sharedSecret.Encode(seed.data(), 32);
 
                 DRNG.SetKeyWithIV(seed.data(), 16, seed.data() + 16, 16);
 
-
-                uint32_t memberIndex = std::distance(DCNetwork_.members().begin(), DCNetwork_.members().find(memberID));
                 // verify that the commitment is indeed invalid
 
                 CryptoPP::Integer R_;
                 CryptoPP::ECPPoint C_;
                 // skip to the rValue at this point
                 for (uint32_t share = 0; share < k_; share++) {
-                    for (uint32_t slice = 0; slice < numSlices; slice++) {
-                        CryptoPP::Integer r(DRNG, CryptoPP::Integer::One(), curve_.GetMaxExponent());
-                        if(slice == sliceIndex)
-                            R_ += r;
+                    if (DCNetwork_.seededShares()) {
+                        // the blinding factors of each share are expanded from a seed derived from the slot seed
+                        std::vector<CryptoPP::Integer> rValues;
+                        SeededShares::expand(SeededShares::shareSeed(seed, share), numSlices, curve_.GetMaxExponent(),
+                                             rValues);
+                        R_ += rValues[sliceIndex];
+                    } else {
+                        // vector commitments use a single blinding factor per share
+                        size_t numCommitments = DCNetwork_.vectorCommitments() ? 1 : numSlices;
+                        for (uint32_t slice = 0; slice < numCommitments; slice++) {
+                            CryptoPP::Integer r(DRNG, CryptoPP::Integer::One(), curve_.GetMaxExponent());
+                            if(slice == sliceIndex)
+                                R_ += r;
+                        }
                     }
-                    C_ = curve_.GetCurve().Add(C_, commitments_[memberIndex][slotIndex][share][sliceIndex]);
+                    C_ = curve_.GetCurve().Add(C_, oldCommitments_[memberIndex][slotIndex][share][sliceIndex]);
                 }
                 R_ = R_.Modulo(curve_.GetGroupOrder());
 
@@ -198,7 +221,7 @@ std::unique_ptr<DCState> BlameRound::executeTask() {
                 // check if the commitment is invalid
                 if ((C_.x != commitment.x) || (C_.y != commitment.y)) {
                     std::cout << "Suspicious Member removed" << std::endl;
-                    DCNetwork_.members().erase(memberID);
+                    DCNetwork_.excludeMember(memberID);
                 }
             }
             nonEmptySlots++;
@@ -269,8 +292,8 @@ void BlameRound::sharingPartOne(std::vector<std::vector<std::vector<CryptoPP::In
     }
 
     // store the commitment matrix
-    commitments_.reserve(k_);
-    commitments_.insert(std::pair(DCNetwork_.nodeID(), std::move(commitmentCube)));
+    commitments_.assign(k_, std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>>(2 * k_));
+    commitments_[nodeIndex_] = std::move(commitmentCube);
 
     // store the random values used for the Commitments of the own share
 
@@ -296,14 +319,6 @@ void BlameRound::sharingPartOne(std::vector<std::vector<std::vector<CryptoPP::In
         }
     }
 
-    // prepare the commitment storage
-    for (auto member = DCNetwork_.members().begin(); member != DCNetwork_.members().end(); member++) {
-        std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>> commitmentCube;
-        commitmentCube.reserve(2 * k_);
-
-        commitments_.insert(std::pair(member->second.nodeID(), std::move(commitmentCube)));
-    }
-
     // collect the commitments from the other k-1 members
     uint32_t remainingCommitments = 2 * k_ * (k_ - 1);
     while (remainingCommitments > 0) {
@@ -316,6 +331,8 @@ void BlameRound::sharingPartOne(std::vector<std::vector<std::vector<CryptoPP::In
 
             // decode the slot and the share
             uint32_t slot = (commitBroadcast.body()[0] << 8) | (commitBroadcast.body()[1]);
+            uint32_t memberIndex = std::distance(DCNetwork_.members().begin(),
+                                                 DCNetwork_.members().find(commitBroadcast.senderID()));
 
             for (uint32_t share = 0, offset = 2; share < k_; share++) {
                 std::vector<CryptoPP::ECPPoint> commitmentVector;
@@ -331,7 +348,7 @@ void BlameRound::sharingPartOne(std::vector<std::vector<std::vector<CryptoPP::In
                 }
                 commitmentMatrix.push_back(std::move(commitmentVector));
             }
-            commitments_[commitBroadcast.senderID()].push_back(std::move(commitmentMatrix));
+            commitments_[memberIndex][slot] = std::move(commitmentMatrix);
 
             remainingCommitments--;
         } else {
@@ -374,6 +391,8 @@ int BlameRound::sharingPartTwo() {
         if (sharingMessage.msgType() == BlameRoundFirstSharing) {
 
             uint32_t slot = (sharingMessage.body()[0] << 8) | sharingMessage.body()[1];
+            uint32_t memberIndex = std::distance(DCNetwork_.members().begin(),
+                                                 DCNetwork_.members().find(sharingMessage.senderID()));
 
             for (uint32_t slice = 0, offset = 2; slice < numSlices; slice++, offset += 64) {
                 CryptoPP::Integer r(&sharingMessage.body()[offset], 32);
@@ -382,8 +401,8 @@ int BlameRound::sharingPartTwo() {
                 // verify that the corresponding commitment is valid
                 CryptoPP::ECPPoint commitment = commit(r, s);
                 // if the commitment is invalid, blame the sender
-                if ((commitment.x != commitments_[sharingMessage.senderID()][slot][DCNetwork_.nodeID()][slice].x)
-                    || (commitment.y != commitments_[sharingMessage.senderID()][slot][DCNetwork_.nodeID()][slice].y)) {
+                if ((commitment.x != commitments_[memberIndex][slot][nodeIndex_][slice].x)
+                    || (commitment.y != commitments_[memberIndex][slot][nodeIndex_][slice].y)) {
 
                     BlameRound::injectBlameMessage(sharingMessage.senderID(), slot, slice, r, s);
                     std::cout << "Invalid commitment detected 1" << std::endl;
@@ -458,8 +477,7 @@ std::vector<std::vector<uint8_t>> BlameRound::resultComputation() {
                 // validate r and s
                 CryptoPP::ECPPoint addedCommitments;
                 for (auto &c : commitments_)
-                    addedCommitments = curve_.GetCurve().Add(addedCommitments,
-                                                             c.second[slot][memberIndex][slice]);
+                    addedCommitments = curve_.GetCurve().Add(addedCommitments, c[slot][memberIndex][slice]);
 
                 CryptoPP::ECPPoint commitment = commit(R_, S_);
 
@@ -582,13 +600,13 @@ void BlameRound::handleBlameMessage(ReceivedMessage &blameMessage) {
 
     // compare the commitment, generated using the submitted values, with the commitment
     // which has been broadcasted by the suspect
-    if ((commitment.x != commitments_[suspectID][slot][memberIndex][slice].x)
-        || (commitment.y != commitments_[suspectID][slot][memberIndex][slice].y)) {
+    if ((commitment.x != commitments_[memberIndex][slot][memberIndex][slice].x)
+        || (commitment.y != commitments_[memberIndex][slot][memberIndex][slice].y)) {
         // if the two commitments do not match, the suspect is removed
-        DCNetwork_.members().erase(suspectID);
+        DCNetwork_.excludeMember(suspectID);
     } else {
         // if the two commitments match, the sender is removed
-        DCNetwork_.members().erase(blameMessage.senderID());
+        DCNetwork_.excludeMember(blameMessage.senderID());
     }
 }
 
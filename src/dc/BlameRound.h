@@ -9,11 +9,11 @@
 class BlameRound : public DCState {
 public:
     // constructor used by a witness
-    BlameRound(DCNetwork& DCNet, std::unordered_map<uint32_t, std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>>> oldCommitments);
+    BlameRound(DCNetwork& DCNet, std::vector<std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>>> oldCommitments);
 
     // constructor used by a victim
     BlameRound(DCNetwork& DCNet, int slot, uint16_t slice, uint32_t suspiciousMember_, CryptoPP::Integer seedPrivateKey,
-               std::unordered_map<uint32_t, std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>>> oldCommitments);
+               std::vector<std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>>> oldCommitments);
 
     virtual ~BlameRound();
 
@@ -48,11 +48,13 @@ private:
 
     CryptoPP::Integer seedPrivateKey_;
 
-    std::unordered_map<uint32_t, std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>>> oldCommitments_;
+    // commitments of the disrupted round, indexed by the position of the sender in the member list
+    std::vector<std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>>> oldCommitments_;
 
     std::vector<std::vector<std::vector<CryptoPP::Integer>>> rValues_;
 
-    std::unordered_map<uint32_t, std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>>> commitments_;
+    // commitments of this round, indexed by the position of the sender in the member list
+    std::vector<std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>>> commitments_;
 
     // sum of all shares
     std::vector<std::vector<CryptoPP::Integer>> S;
@@ -4,10 +4,10 @@
 #include "DCMember.h"
 
 DCMember::DCMember(uint32_t nodeID, uint32_t connectionID)
-: nodeID_(nodeID), connectionID_(connectionID ) {}
+: nodeID_(nodeID), connectionID_(connectionID ), pairwiseSeed_(), padKey_() {}
 
 DCMember::DCMember(uint32_t nodeID, uint32_t connectionID, CryptoPP::ECPPoint publicKey)
-: nodeID_(nodeID), connectionID_(connectionID), publicKey_(publicKey) {}
+: nodeID_(nodeID), connectionID_(connectionID), publicKey_(publicKey), pairwiseSeed_(), padKey_() {}
 
 uint32_t DCMember::nodeID() {
     return nodeID_;
@@ -19,4 +19,20 @@ uint32_t DCMember::connectionID() {
 
 const CryptoPP::ECPPoint& DCMember::publicKey() {
     return publicKey_;
-}
\ No newline at end of file
+}
+
+void DCMember::pairwiseSeed(const std::array<uint8_t, 32>& seed) {
+    pairwiseSeed_ = seed;
+}
+
+const std::array<uint8_t, 32>& DCMember::pairwiseSeed() {
+    return pairwiseSeed_;
+}
+
+void DCMember::padKey(const std::array<uint8_t, 32>& key) {
+    padKey_ = key;
+}
+
+const std::array<uint8_t, 32>& DCMember::padKey() {
+    return padKey_;
+}
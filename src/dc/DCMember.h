@@ -2,6 +2,7 @@
 #define THREEPP_DCMEMBER_H
 
 #include <cstdint>
+#include <array>
 #include <cryptopp/ecpoint.h>
 
 class DCNetwork;
@@ -18,12 +19,26 @@ public:
 
     const CryptoPP::ECPPoint& publicKey();
 
+    void pairwiseSeed(const std::array<uint8_t, 32>& seed);
+
+    // seed shared with this member, derived from the static Diffie-Hellman secret
+    const std::array<uint8_t, 32>& pairwiseSeed();
+
+    void padKey(const std::array<uint8_t, 32>& key);
+
+    // key of the pads shared with this member, derived from the pairwise seed and the nonce of the group
+    const std::array<uint8_t, 32>& padKey();
+
 private:
     uint32_t nodeID_;
 
     uint32_t connectionID_;
 
     CryptoPP::ECPPoint publicKey_;
+
+    std::array<uint8_t, 32> pairwiseSeed_;
+
+    std::array<uint8_t, 32> padKey_;
 };
 
 
@@ -1,47 +1,201 @@
+#include <cmath>
+#include <numeric>
+#include <algorithm>
+#include <thread>
 #include <cryptopp/oids.h>
+#include <cryptopp/modes.h>
+#include <cryptopp/aes.h>
+#include <cryptopp/sha.h>
 #include "DCNetwork.h"
 #include "InitState.h"
+#include "../datastruct/MessageType.h"
+#include "../datastruct/MessageFragmentation.h"
+#include "../datastruct/MessageCompression.h"
 
 DCNetwork::DCNetwork(DCMember self, size_t k, SecurityLevel securityLevel, CryptoPP::Integer privateKey,
         uint32_t numThreads, std::unordered_map<uint32_t, Node>& neigbors, MessageQueue<ReceivedMessage>& inboxDC,
-        MessageQueue<OutgoingMessage>& outboxThreePP, uint32_t interval, bool fullProtocol, bool logging,
-        bool preparedCommitments, bool AD)
+        MessageQueue<OutgoingMessage>& outboxThreePP, const DCNetworkOptions& options)
 : nodeID_(self.nodeID()), k_(k), securityLevel_(securityLevel), privateKey_(privateKey), numThreads_(numThreads), neighbors_(neigbors),
   inboxDC_(inboxDC), outboxThreePP_(outboxThreePP), state_(std::make_unique<InitState>(*this)),
-  interval_(interval), fullProtocol_(fullProtocol), logging_(logging), AD_(AD) {
+  interval_(options.interval), fullProtocol_(options.fullProtocol), logging_(options.logging), AD_(options.AD),
+  seededShares_(options.seededShares), vectorCommitments_(options.vectorCommitments),
+  optimisticCommitments_(options.optimisticCommitments), auditRate_(options.auditRate), auditedSlices_(0),
+  receivedSlices_(0), speculativeVerification_(options.speculativeVerification), pipelining_(options.pipelining),
+  maxSlots_(options.maxSlots), batching_(options.batching), lingerTime_(options.lingerTime),
+  fragmentation_(options.fragmentation), leaseRounds_(options.leaseRounds),
+  compactReservation_(options.compactReservation),
+  slotCapacity_(MessageBatch::MAX_PAYLOAD_SIZE - leaseSize(k, securityLevel, options.leaseRounds, options.pipelining,
+                                                          options.compactReservation)),
+  compression_(options.compression),
+  fastRecovery_(options.fastRecovery), epochTagging_(options.pipelining || options.fastRecovery), epoch_(0),
+  firstOpenEpoch_(0), hybridFallbackEpoch_(0) {
     members_.insert(std::pair(nodeID_, self));
+    openBatch_ = MessageBatch(slotCapacity_);
 
-    if(preparedCommitments && (securityLevel_ == Secured))
+    if(options.preparedCommitments && (securityLevel_ == Secured))
         prepareCommitments();
 }
 
 void DCNetwork::run() {
+    if (epochTagging_) {
+        std::thread router(&DCNetwork::routeMessages, this);
+        router.detach();
+    }
+
     for(;;) {
         state_ = state_->executeTask();
     }
 }
 
 void DCNetwork::submitMessage(std::vector<uint8_t>& msg) {
-    submittedMessages_.push(std::move(msg));
+    // the length of the slot is reserved for the compressed message
+    if (compression_)
+        msg = MessageCompression::encode(msg);
+
+    if (!fragmentation_) {
+        DCNetwork::enqueueMessage(msg);
+        return;
+    }
+
+    uint64_t messageID;
+    fragmentationPRNG_.GenerateBlock(reinterpret_cast<uint8_t*>(&messageID), sizeof(messageID));
+
+    // the fragments also fit into a batch
+    std::vector<std::vector<uint8_t>> fragments = MessageFragmentation::split(msg, messageID,
+                                                                              slotCapacity_ - MessageBatch::FRAME_HEADER_SIZE);
+    if (fragments.empty()) {
+        std::cout << "Error: the message exceeds the maximum number of fragments" << std::endl;
+        return;
+    }
+
+    // the fragments are transmitted in consecutive slots
+    for (auto& fragment : fragments)
+        DCNetwork::enqueueMessage(fragment);
+}
+
+void DCNetwork::enqueueMessage(std::vector<uint8_t>& msg) {
+    // the slot of a leased round additionally contains the lease header
+    size_t capacity = batching_ ? slotCapacity_ - MessageBatch::FRAME_HEADER_SIZE : slotCapacity_;
+    if (msg.size() > capacity) {
+        std::cout << "Error: the message exceeds the size of a slot" << std::endl;
+        return;
+    }
+
+    if (!batching_) {
+        submittedMessages_.push_back(std::move(msg));
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(batchMutex_);
+    // start a new batch if the message does not fit into the open one
+    if (!openBatch_.add(msg)) {
+        completedBatches_.push_back(std::move(openBatch_.payload()));
+        openBatch_ = MessageBatch(slotCapacity_);
+        openBatch_.add(msg);
+    }
+}
+
+void DCNetwork::collectBatches() {
+    std::lock_guard<std::mutex> lock(batchMutex_);
+    for (auto& batch : completedBatches_)
+        submittedMessages_.push_back(std::move(batch));
+    completedBatches_.clear();
+
+    if (!openBatch_.empty() && (std::chrono::steady_clock::now() - openBatch_.opened() >= lingerTime_)) {
+        submittedMessages_.push_back(std::move(openBatch_.payload()));
+        openBatch_ = MessageBatch(slotCapacity_);
+    }
 }
 
 std::map<uint32_t, DCMember>& DCNetwork::members() {
     return members_;
 }
 
+std::shared_ptr<const MemberTable> DCNetwork::memberTable() {
+    std::lock_guard<std::mutex> lock(memberTableMutex_);
+    return memberTable_;
+}
+
+void DCNetwork::updateMemberTable() {
+    auto memberTable = std::make_shared<const MemberTable>(members_);
+    std::lock_guard<std::mutex> lock(memberTableMutex_);
+    memberTable_ = std::move(memberTable);
+}
+
 std::unordered_map<uint32_t, Node>& DCNetwork::neighbors() {
     return neighbors_;
 }
 
 MessageQueue<ReceivedMessage>& DCNetwork::inbox() {
-    return inboxDC_;
+    return epochTagging_ ? controlInbox_ : inboxDC_;
+}
+
+MessageQueue<ReceivedMessage>& DCNetwork::inbox(uint64_t epoch) {
+    if (!epochTagging_)
+        return inboxDC_;
+
+    std::lock_guard<std::mutex> lock(epochMutex_);
+    auto& epochInbox = epochInboxes_[epoch];
+    if (!epochInbox)
+        epochInbox = std::make_unique<MessageQueue<ReceivedMessage>>();
+    return *epochInbox;
 }
 
 MessageQueue<OutgoingMessage>& DCNetwork::outbox() {
     return outboxThreePP_;
 }
 
-std::queue<std::vector<uint8_t>>& DCNetwork::submittedMessages() {
+void DCNetwork::send(OutgoingMessage message, uint64_t epoch) {
+    if (!epochTagging_) {
+        outboxThreePP_.push(std::move(message));
+        return;
+    }
+
+    // epoch (8 bytes) and type of the enclosed message, followed by its body
+    std::vector<uint8_t> body(9 + message.body().size());
+    for (uint32_t i = 0; i < 8; i++)
+        body[i] = (epoch >> (56 - 8 * i)) & 0xFF;
+    body[8] = message.msgType();
+    std::copy(message.body().begin(), message.body().end(), &body[9]);
+
+    OutgoingMessage roundMessage(message.receiverID(), RoundMessage, message.senderID(), std::move(body));
+    outboxThreePP_.push(std::move(roundMessage));
+}
+
+void DCNetwork::routeMessages() {
+    for (;;) {
+        auto message = inboxDC_.pop();
+        if ((message.msgType() != RoundMessage) || (message.body().size() < 9)) {
+            controlInbox_.push(std::move(message));
+            continue;
+        }
+
+        uint64_t epoch = 0;
+        for (uint32_t i = 0; i < 8; i++)
+            epoch = (epoch << 8) | message.body()[i];
+
+        // messages of nodes outside of the group and of convicted members are dropped
+        if (!DCNetwork::isMember(message.senderID(), message.connectionID()))
+            continue;
+
+        std::vector<uint8_t> body(message.body().begin() + 9, message.body().end());
+        ReceivedMessage roundMessage(message.connectionID(), message.body()[8], message.senderID(), std::move(body));
+
+        // the check and the insertion are a single critical section,
+        // otherwise nextEpoch could remove the inbox in between
+        std::lock_guard<std::mutex> lock(epochMutex_);
+        // the epoch has already been completed
+        if (epoch < firstOpenEpoch_)
+            continue;
+
+        auto& epochInbox = epochInboxes_[epoch];
+        if (!epochInbox)
+            epochInbox = std::make_unique<MessageQueue<ReceivedMessage>>();
+        epochInbox->push(std::move(roundMessage));
+    }
+}
+
+std::deque<std::vector<uint8_t>>& DCNetwork::submittedMessages() {
     return submittedMessages_;
 }
 
@@ -70,6 +224,9 @@ uint32_t DCNetwork::interval() {
 }
 
 bool DCNetwork::fullProtocol() {
+    // the Adaptive security level validates all commitments only after blame evidence appeared
+    if (securityLevel_ == Adaptive)
+        return fullProtocol_ || (adaptiveSecurity_.level() == AdaptiveValidated);
     return fullProtocol_;
 }
 
@@ -77,6 +234,182 @@ bool DCNetwork::AD() {
     return AD_;
 }
 
+bool DCNetwork::seededShares() {
+    return seededShares_;
+}
+
+bool DCNetwork::vectorCommitments() {
+    return vectorCommitments_;
+}
+
+bool DCNetwork::optimisticCommitments() {
+    return optimisticCommitments_;
+}
+
+double DCNetwork::auditRate() {
+    return auditRate_;
+}
+
+bool DCNetwork::speculativeVerification() {
+    return speculativeVerification_;
+}
+
+bool DCNetwork::pipelining() {
+    return pipelining_;
+}
+
+uint32_t DCNetwork::maxSlots() {
+    return maxSlots_;
+}
+
+uint32_t DCNetwork::leaseRounds() {
+    return leaseRounds_;
+}
+
+size_t DCNetwork::leaseSize() {
+    return leaseSize(k_, securityLevel_, leaseRounds_, pipelining_, compactReservation_);
+}
+
+size_t DCNetwork::leaseSize(size_t k, SecurityLevel securityLevel, uint32_t leaseRounds, bool pipelining,
+                            bool compactReservation) {
+    // the leased rounds replace the initial rounds of the secured mode,
+    // which are executed alongside the final rounds in the pipelined mode
+    if ((leaseRounds == 0) || (securityLevel != Secured) || pipelining)
+        return 0;
+
+    // same layout as a reservation without the CRC and the count of shared reservations
+    return 4 + 33 * (compactReservation ? 1 : k);
+}
+
+size_t DCNetwork::slotCapacity() {
+    return slotCapacity_;
+}
+
+bool DCNetwork::compactReservation() {
+    return compactReservation_;
+}
+
+bool DCNetwork::fastRecovery() {
+    return fastRecovery_;
+}
+
+void DCNetwork::excludeMember(uint32_t memberID) {
+    if (!fastRecovery_) {
+        members_.erase(memberID);
+        updateMemberTable();
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(exclusionMutex_);
+    convictedMembers_.insert(memberID);
+}
+
+std::set<uint32_t> DCNetwork::convictedMembers() {
+    std::lock_guard<std::mutex> lock(exclusionMutex_);
+    return convictedMembers_;
+}
+
+bool DCNetwork::isMember(uint32_t nodeID, uint32_t connectionID) {
+    {
+        std::lock_guard<std::mutex> lock(exclusionMutex_);
+        if (convictedMembers_.count(nodeID) > 0)
+            return false;
+    }
+
+    // the group is still being formed
+    auto memberTable = DCNetwork::memberTable();
+    if (!memberTable)
+        return true;
+
+    int memberIndex = memberTable->index(nodeID);
+    return (memberIndex >= 0) && (memberTable->connectionID(memberIndex) == connectionID);
+}
+
+void DCNetwork::applyExclusions() {
+    std::lock_guard<std::mutex> lock(exclusionMutex_);
+    if (convictedMembers_.empty())
+        return;
+
+    for (uint32_t memberID : convictedMembers_)
+        members_.erase(memberID);
+    convictedMembers_.clear();
+
+    k_ = members_.size();
+    std::cout << "Node " << nodeID_ << ": continuing with " << k_ << " members" << std::endl;
+
+    // the prepared commitments depend on the group size
+    if (!preparedCommitments_.empty()) {
+        preparedCommitments_.clear();
+        prepareCommitments();
+    }
+}
+
+void DCNetwork::discardExclusions() {
+    std::lock_guard<std::mutex> lock(exclusionMutex_);
+    for (uint32_t memberID : convictedMembers_)
+        members_.erase(memberID);
+    convictedMembers_.clear();
+}
+
+size_t DCNetwork::reservationSize() {
+    // the count of shared reservations follows the ephemeral keys if the members may reserve shared slots
+    return 8 + 33 * (compactReservation_ ? 1 : k_) + (maxSlots_ > 1 ? 1 : 0);
+}
+
+uint32_t DCNetwork::disruptedSharedSlots(uint32_t invalidSlots, uint32_t validSlots, uint32_t sharedReservations) {
+    // each valid shared slot holds one of the announced reservations
+    // and each collision consumes at least two of the remaining ones
+    uint32_t collidingReservations = (sharedReservations > validSlots) ? sharedReservations - validSlots : 0;
+    return invalidSlots - std::min(invalidSlots, collidingReservations / 2);
+}
+
+std::vector<uint32_t> DCNetwork::reserveSlots(CryptoPP::RandomNumberGenerator& rng) {
+    if (batching_)
+        DCNetwork::collectBatches();
+
+    std::vector<uint32_t> reservedSlots;
+    if (submittedMessages_.empty())
+        return reservedSlots;
+
+    // the first k slots are assigned to the members in the order of their IDs
+    uint32_t nodeIndex = std::distance(members_.begin(), members_.find(nodeID_));
+    reservedSlots.push_back(nodeIndex);
+
+    // collisions in the shared slots are detected by the CRC of the slot
+    // the number of shared reservations is announced in a single byte
+    size_t numSlots = std::min<size_t>({submittedMessages_.size(), maxSlots_, k_ + 1, 256});
+    std::vector<uint32_t> sharedSlots(k_);
+    std::iota(sharedSlots.begin(), sharedSlots.end(), k_);
+    for (uint32_t i = 1; i < numSlots; i++) {
+        uint32_t j = rng.GenerateWord32(i - 1, k_ - 1);
+        std::swap(sharedSlots[i - 1], sharedSlots[j]);
+        reservedSlots.push_back(sharedSlots[i - 1]);
+    }
+    return reservedSlots;
+}
+
+void DCNetwork::recordAudit(uint64_t auditedSlices, uint64_t receivedSlices) {
+    auditedSlices_ += auditedSlices;
+    receivedSlices_ += receivedSlices;
+
+    if (logging_ && (receivedSlices > 0))
+        std::cout << "Node " << nodeID_ << ": audited " << auditedSlices << " of " << receivedSlices
+                  << " slices, detection probability " << detectionProbability() << std::endl;
+}
+
+double DCNetwork::detectionProbability(uint32_t corruptedSlices) {
+    if (receivedSlices_ == 0)
+        return 0;
+
+    // each slice is audited independently with the observed audit rate
+    double auditRate = static_cast<double>(auditedSlices_) / receivedSlices_;
+    return 1 - std::pow(1 - auditRate, corruptedSlices);
+}
+
+AdaptiveSecurity& DCNetwork::adaptiveSecurity() {
+    return adaptiveSecurity_;
+}
+
 bool DCNetwork::logging() {
     return logging_;
 }
@@ -87,7 +420,7 @@ void DCNetwork::prepareCommitments() {
     CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP> curve;
     curve.Initialize(CryptoPP::ASN1::secp256k1());
 
-    uint32_t numSlices = std::ceil((8 + 33 * k_) / 31.0);
+    uint32_t numSlices = std::ceil(reservationSize() / 31.0);
 
     preparedCommitments_.resize(2*k_);
     for(uint32_t slot = 0; slot < 2*k_; slot++) {
@@ -105,4 +438,92 @@ void DCNetwork::prepareCommitments() {
 
 std::vector<std::vector<std::vector<std::pair<CryptoPP::Integer, CryptoPP::ECPPoint>>>>& DCNetwork::preparedCommitments() {
     return preparedCommitments_;
+}
+
+std::array<uint8_t, 32> DCNetwork::deriveSeed(const CryptoPP::ECPPoint& publicKey) {
+    CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP> curve;
+    curve.Initialize(CryptoPP::ASN1::secp256k1());
+
+    CryptoPP::Integer sharedSecret = curve.GetCurve().ScalarMultiply(publicKey, privateKey_).x;
+    std::array<uint8_t, 32> encodedSecret;
+    sharedSecret.Encode(encodedSecret.data(), 32);
+
+    std::array<uint8_t, 32> seed;
+    CryptoPP::SHA256 sha256;
+    sha256.Update(encodedSecret.data(), encodedSecret.size());
+    sha256.Final(seed.data());
+    return seed;
+}
+
+uint64_t DCNetwork::nextEpoch() {
+    std::lock_guard<std::mutex> lock(epochMutex_);
+    // the final round of the previous epoch may still be running
+    if (epoch_ > 0) {
+        firstOpenEpoch_ = std::max(firstOpenEpoch_, epoch_ - 1);
+        epochInboxes_.erase(epochInboxes_.begin(), epochInboxes_.lower_bound(firstOpenEpoch_));
+    }
+    return epoch_++;
+}
+
+uint64_t DCNetwork::epoch() {
+    std::lock_guard<std::mutex> lock(epochMutex_);
+    return epoch_;
+}
+
+void DCNetwork::resumeEpoch(uint64_t epoch) {
+    std::lock_guard<std::mutex> lock(epochMutex_);
+    // no round is running while the group is synchronized
+    epoch_ = std::max(epoch_, epoch);
+    firstOpenEpoch_ = epoch_;
+    epochInboxes_.erase(epochInboxes_.begin(), epochInboxes_.lower_bound(firstOpenEpoch_));
+}
+
+bool DCNetwork::hybridPayloads(uint64_t epoch) {
+    std::lock_guard<std::mutex> lock(epochMutex_);
+    return (securityLevel_ == Hybrid) && (epoch >= hybridFallbackEpoch_);
+}
+
+uint64_t DCNetwork::hybridFallbackEpoch() {
+    std::lock_guard<std::mutex> lock(epochMutex_);
+    return hybridFallbackEpoch_;
+}
+
+void DCNetwork::fallBackToCommittedPayloads(uint64_t untilEpoch) {
+    std::lock_guard<std::mutex> lock(epochMutex_);
+    hybridFallbackEpoch_ = std::max(hybridFallbackEpoch_, untilEpoch);
+}
+
+void DCNetwork::rekey(const std::array<uint8_t, 32>& groupNonce) {
+    for (auto& member : members_) {
+        if (member.first == nodeID_)
+            continue;
+
+        std::array<uint8_t, 32> padKey;
+        CryptoPP::SHA256 sha256;
+        sha256.Update(member.second.pairwiseSeed().data(), 32);
+        sha256.Update(groupNonce.data(), groupNonce.size());
+        sha256.Final(padKey.data());
+        member.second.padKey(padKey);
+    }
+}
+
+void DCNetwork::applyPads(uint8_t* data, size_t length, uint64_t epoch, PadRound round, uint32_t slot) {
+    // the IV consists of the epoch, the round and the slot, which all members share,
+    // the counter occupies the last four bytes of the IV
+    std::array<uint8_t, 16> IV{};
+    for (uint32_t i = 0; i < 8; i++)
+        IV[i] = (epoch >> (56 - 8 * i)) & 0xFF;
+    IV[8]  = round;
+    IV[9]  = (slot & 0x00FF0000) >> 16;
+    IV[10] = (slot & 0x0000FF00) >> 8;
+    IV[11] = (slot & 0x000000FF);
+
+    CryptoPP::CTR_Mode<CryptoPP::AES>::Encryption cipher;
+    for (auto& member : members_) {
+        if (member.first == nodeID_)
+            continue;
+
+        cipher.SetKeyWithIV(member.second.padKey().data(), 32, IV.data(), IV.size());
+        cipher.ProcessData(data, data, length);
+    }
 }
\ No newline at end of file
@@ -2,6 +2,11 @@
 #define THREEPP_DCNETWORK_H
 
 #include <map>
+#include <set>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <cstdlib>
 #include <cryptopp/ecp.h>
 #include <cryptopp/eccrypto.h>
@@ -11,7 +16,10 @@
 #include "../datastruct/ReceivedMessage.h"
 #include "DCState.h"
 #include "../datastruct/OutgoingMessage.h"
+#include "../datastruct/MessageBatch.h"
 #include "DCMember.h"
+#include "MemberTable.h"
+#include "AdaptiveSecurity.h"
 #include "../network/Node.h"
 
 const CryptoPP::ECPPoint G(CryptoPP::Integer("362dc3caf8a0e8afd06f454a6da0cdce6e539bc3f15e79a15af8aa842d7e3ec2h"),
@@ -24,25 +32,90 @@ enum SecurityLevel {
     Unsecured,
     Secured,
     Adaptive,
-    ProofOfFairness
+    ProofOfFairness,
+    // the payload is transmitted using the pads of the unsecured rounds,
+    // only its digest and length are transmitted in the secured final round
+    Hybrid
+};
+
+// distinguishes the pads of the rounds of an epoch
+enum PadRound : uint8_t {
+    InitialRoundPads,
+    FinalRoundPads
+};
+
+// optional features of the DC network, which can be combined
+struct DCNetworkOptions {
+    uint32_t interval = 0;
+
+    // validates all commitments of the secured rounds instead of delaying the verification until a CRC fails
+    bool fullProtocol = true;
+
+    bool logging = false;
+
+    bool preparedCommitments = false;
+
+    bool AD = false;
+
+    bool seededShares = false;
+
+    bool vectorCommitments = false;
+
+    // requires the delayed verification
+    bool optimisticCommitments = false;
+
+    // fraction of the slices, which are verified in the delayed verification mode
+    double auditRate = 0;
+
+    bool speculativeVerification = false;
+
+    bool pipelining = false;
+
+    uint32_t maxSlots = 1;
+
+    bool batching = false;
+
+    // time in milliseconds an open batch waits for further messages
+    uint32_t lingerTime = 0;
+
+    bool fragmentation = false;
+
+    uint32_t leaseRounds = 0;
+
+    bool compactReservation = false;
+
+    bool compression = false;
+
+    bool fastRecovery = false;
 };
 
 class DCNetwork {
 public:
     DCNetwork(DCMember self, size_t k, SecurityLevel securityLevel, CryptoPP::Integer privateKey, uint32_t numThreads,
             std::unordered_map<uint32_t, Node>& neighbors, MessageQueue<ReceivedMessage>& inboxDC,
-            MessageQueue<OutgoingMessage>& outboxThreePP, uint32_t interval = 0, bool fullProtocol = true, bool logging = false,
-            bool preparedCommitments = false, bool AD = false);
+            MessageQueue<OutgoingMessage>& outboxThreePP, const DCNetworkOptions& options = DCNetworkOptions());
 
     std::map<uint32_t, DCMember>& members();
 
+    // snapshot of the ordered member list, which the rounds capture at their construction
+    std::shared_ptr<const MemberTable> memberTable();
+
+    // rebuilds the member table after the membership has changed
+    void updateMemberTable();
+
     std::unordered_map<uint32_t, Node>& neighbors();
 
     MessageQueue<ReceivedMessage>& inbox();
 
+    // inbox of the secured rounds of an epoch, which equals the regular inbox without pipelining
+    MessageQueue<ReceivedMessage>& inbox(uint64_t epoch);
+
     MessageQueue<OutgoingMessage>& outbox();
 
-    std::queue<std::vector<uint8_t>>& submittedMessages();
+    // sends a message of a secured round, which is tagged with the epoch of the round in the pipelined mode
+    void send(OutgoingMessage message, uint64_t epoch);
+
+    std::deque<std::vector<uint8_t>>& submittedMessages();
 
     uint32_t nodeID();
 
@@ -60,17 +133,134 @@ public:
 
     bool AD();
 
+    bool seededShares();
+
+    bool vectorCommitments();
+
+    bool optimisticCommitments();
+
+    double auditRate();
+
+    bool speculativeVerification();
+
+    bool pipelining();
+
+    uint32_t maxSlots();
+
+    // maximum number of consecutive final rounds in which the slots are leased without a reservation round
+    uint32_t leaseRounds();
+
+    // size of the lease header, which precedes the message in the slots of the secured final round,
+    // zero if the slots are not leased
+    size_t leaseSize();
+
+    static size_t leaseSize(size_t k, SecurityLevel securityLevel, uint32_t leaseRounds, bool pipelining,
+                            bool compactReservation);
+
+    // maximum size of a slot's payload, which leaves room for the lease header of the initial group
+    size_t slotCapacity();
+
+    // determines whether a reservation carries a single ephemeral public key for all members
+    // instead of one key per member
+    bool compactReservation();
+
+    bool fastRecovery();
+
+    // removes a convicted member from the group,
+    // in the fast recovery mode the member is removed once the remaining members agreed on the convicted members
+    // and the group continues with the remaining members
+    void excludeMember(uint32_t memberID);
+
+    // members which have been convicted in the fast recovery mode but not yet excluded
+    std::set<uint32_t> convictedMembers();
+
+    // removes the convicted members and adjusts the group size,
+    // called once all members agreed on the convicted members
+    void applyExclusions();
+
+    // removes the convicted members without adjusting the group size,
+    // like the regular recovery the group then waits for new members
+    void discardExclusions();
+
+    // size of a slot in the secured initial round: CRC, round identifier, length, the ephemeral keys
+    // and the number of shared slots the owner of the slot reserved in addition
+    size_t reservationSize();
+
+    // number of invalid shared slots, which cannot be explained by collisions of the shared reservations
+    // announced in the own slots of the members
+    uint32_t disruptedSharedSlots(uint32_t invalidSlots, uint32_t validSlots, uint32_t sharedReservations);
+
+    // selects the slots of the initial round in the order of the submitted messages:
+    // the own slot for the first message and random slots of the shared upper half of the 2k slots
+    // for further messages, up to maxSlots in total
+    std::vector<uint32_t> reserveSlots(CryptoPP::RandomNumberGenerator& rng);
+
+    // adds the number of audited and received slices of a round to the audit statistics
+    void recordAudit(uint64_t auditedSlices, uint64_t receivedSlices);
+
+    // probability that a sender, which corrupts the given number of slices, is detected by a single node
+    double detectionProbability(uint32_t corruptedSlices = 1);
+
+    AdaptiveSecurity& adaptiveSecurity();
+
     bool logging();
 
     void run();
 
+    // in the batching mode the message is appended to the open batch,
+    // which is submitted as a single slot payload,
+    // in the fragmentation mode the message is split into fragments of at most one slot,
+    // in the compression mode the message is compressed before the fragmentation
     void submitMessage(std::vector<uint8_t>& msg);
 
     std::vector<std::vector<std::vector<std::pair<CryptoPP::Integer, CryptoPP::ECPPoint>>>>& preparedCommitments();
 
+    // hash of the static Diffie-Hellman secret shared with the owner of the public key
+    std::array<uint8_t, 32> deriveSeed(const CryptoPP::ECPPoint& publicKey);
+
+    // identifies the pairs of secured initial and final rounds,
+    // the inboxes of all epochs before the previous one are removed
+    uint64_t nextEpoch();
+
+    // the epoch which is assigned to the next initial round
+    uint64_t epoch();
+
+    // continues with the epoch the group agreed on, the messages of all earlier epochs are dropped
+    void resumeEpoch(uint64_t epoch);
+
+    // the hybrid mode transmits the payloads with the XOR pads,
+    // unless the group fell back to fully committed payloads for the given epoch
+    bool hybridPayloads(uint64_t epoch);
+
+    // the first epoch in which the payloads are transmitted with the XOR pads again
+    uint64_t hybridFallbackEpoch();
+
+    // transmits the payloads in the secured final round until the given epoch,
+    // since a disrupted XOR payload cannot be attributed to a member
+    void fallBackToCommittedPayloads(uint64_t untilEpoch);
+
+    // derives the keys of the pads from the pairwise seeds and the nonce the group agreed on,
+    // the pads therefore change whenever the group is formed again
+    void rekey(const std::array<uint8_t, 32>& groupNonce);
+
+    // XORs the pads shared with all other members to the data,
+    // the pads of each pair cancel out when the data of all members is added
+    void applyPads(uint8_t* data, size_t length, uint64_t epoch, PadRound round, uint32_t slot);
+
 private:
     void prepareCommitments();
 
+    // forwards the tagged messages into the inbox of their epoch
+    void routeMessages();
+
+    // determines whether the node is a member of the current group, which is connected through the given connection
+    bool isMember(uint32_t nodeID, uint32_t connectionID);
+
+    // moves the completed batches and the expired open batch to the submitted messages
+    void collectBatches();
+
+    void enqueueMessage(std::vector<uint8_t>& msg);
+
     uint32_t nodeID_;
 
     size_t k_;
@@ -89,7 +279,7 @@ private:
 
     MessageQueue<OutgoingMessage>& outboxThreePP_;
 
-    std::queue<std::vector<uint8_t>> submittedMessages_;
+    std::deque<std::vector<uint8_t>> submittedMessages_;
 
     // current state of the DC network
     std::unique_ptr<DCState> state_;
@@ -104,6 +294,91 @@ private:
 
     bool AD_;
 
+    // determines whether the shares of the secured rounds are expanded from seeds
+    bool seededShares_;
+
+    // determines whether the final round commits to each share with a single vector commitment
+    bool vectorCommitments_;
+
+    // determines whether only digests of the commitments are exchanged if the commitments are not validated
+    bool optimisticCommitments_;
+
+    // probability with which a received slice is verified if the commitments are not validated
+    double auditRate_;
+
+    std::atomic<uint64_t> auditedSlices_;
+
+    std::atomic<uint64_t> receivedSlices_;
+
+    // determines whether the shares are verified alongside the sharing instead of before the next step
+    bool speculativeVerification_;
+
+    // determines whether the initial round of the next epoch is executed alongside the final round
+    bool pipelining_;
+
+    // maximum number of slots reserved by this node in a single initial round
+    uint32_t maxSlots_;
+
+    bool batching_;
+
+    // time for which a batch waits for further messages before it is submitted
+    std::chrono::milliseconds lingerTime_;
+
+    // the messages are submitted by another thread
+    std::mutex batchMutex_;
+
+    MessageBatch openBatch_;
+
+    std::deque<std::vector<uint8_t>> completedBatches_;
+
+    bool fragmentation_;
+
+    // generates the message IDs of the fragments
+    CryptoPP::AutoSeededRandomPool fragmentationPRNG_;
+
+    uint32_t leaseRounds_;
+
+    bool compactReservation_;
+
+    // the lease header only shrinks if members are excluded
+    size_t slotCapacity_;
+
+    bool compression_;
+
+    // determines whether an aborted round is restarted immediately, without waiting for a new member
+    bool fastRecovery_;
+
+    // the messages of the secured rounds are tagged with their epoch
+    // in the pipelined and in the fast recovery mode
+    bool epochTagging_;
+
+    // the members are convicted by the threads of a round
+    std::mutex exclusionMutex_;
+
+    std::set<uint32_t> convictedMembers_;
+
+    std::mutex memberTableMutex_;
+
+    std::shared_ptr<const MemberTable> memberTable_;
+
+    uint64_t epoch_;
+
+    // messages of the pipelined rounds are removed from the inbox and dispatched by their epoch,
+    // all other messages are forwarded to this inbox
+    MessageQueue<ReceivedMessage> controlInbox_;
+
+    std::mutex epochMutex_;
+
+    std::map<uint64_t, std::unique_ptr<MessageQueue<ReceivedMessage>>> epochInboxes_;
+
+    // messages of earlier epochs are dropped
+    uint64_t firstOpenEpoch_;
+
+    uint64_t hybridFallbackEpoch_;
+
+    // current level and escalation history of the Adaptive security level
+    AdaptiveSecurity adaptiveSecurity_;
+
     // currently used only for the evaluation
     std::vector<std::vector<std::vector<std::pair<CryptoPP::Integer, CryptoPP::ECPPoint>>>> preparedCommitments_;
 };
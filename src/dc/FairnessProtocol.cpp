@@ -11,7 +11,7 @@ std::mutex cout_mutex1;
 
 FairnessProtocol::FairnessProtocol(DCNetwork &DCNet, size_t numSlices, size_t slotIndex,
                                  std::vector<std::vector<std::vector<CryptoPP::Integer>>> rValues,
-                                 std::unordered_map<uint32_t, std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>>> commitments)
+                                 std::vector<std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>>> commitments)
         : DCNetwork_(DCNet), k_(DCNetwork_.k()), numSlices_(numSlices), slotIndex_(slotIndex), rValues_(std::move(rValues)),
           commitments_(std::move(commitments)) {
 
@@ -24,6 +24,9 @@ FairnessProtocol::FairnessProtocol(DCNetwork &DCNet, size_t numSlices, size_t sl
 FairnessProtocol::~FairnessProtocol() {}
 
 std::unique_ptr<DCState> FairnessProtocol::executeTask() {
+    if (DCNetwork_.securityLevel() == Adaptive)
+        DCNetwork_.adaptiveSecurity().escalate(AdaptiveValidated, "fairness protocol");
+
     std::vector<double> runtimes;
     auto start = std::chrono::high_resolution_clock::now();
 
@@ -76,6 +79,8 @@ std::unique_ptr<DCState> FairnessProtocol::executeTask() {
 
     if(DCNetwork_.securityLevel() == Secured)
         return std::make_unique<SecuredInitialRound>(DCNetwork_);
+    else if(DCNetwork_.securityLevel() == Adaptive)
+        return InitState::initialRound(DCNetwork_);
     else
         return std::make_unique<FairnessProtocol>(DCNetwork_, numSlices_, slotIndex_, rValues_, commitments_);
 }
@@ -284,7 +289,7 @@ void FairnessProtocol::distributeCommitments() {
             // add the commitment and random value r of each share of each slice
             for (uint32_t share = 0; share < k_; share++) {
                 sumC_[slot][slice] = curve_.GetCurve().Add(sumC_[slot][slice],
-                                                           commitments_[DCNetwork_.nodeID()][slot][share][slice]);
+                                                           commitments_[nodeIndex_][slot][share][slice]);
                 rho_[slot][slice] += rValues_[slot][share][slice];
             }
 
@@ -413,7 +418,7 @@ int FairnessProtocol::openCommitments() {
                 if ((newCommitments_[receivedMessage.senderID()][slot][slice].x != commitment.x)
                     || (newCommitments_[receivedMessage.senderID()][slot][slice].y != commitment.y)) {
                     std::cout << "Proof of fairness: invalid commitment detected" << std::endl;
-                    DCNetwork_.members().erase(receivedMessage.senderID());
+                    DCNetwork_.excludeMember(receivedMessage.senderID());
                     return -1;
                 }
             }
@@ -668,6 +673,8 @@ int FairnessProtocol::proofKnowledge() {
         if (wBroadcast.msgType() == ProofOfFairnessZeroKnowledgeProof) {
 
             uint32_t slot = (wBroadcast.body()[0] << 8) | wBroadcast.body()[1];
+            uint32_t memberIndex = std::distance(DCNetwork_.members().begin(),
+                                                 DCNetwork_.members().find(wBroadcast.senderID()));
 
             for (uint32_t slice = 0, offset = 2; slice < numSlices_; slice++, offset += 32) {
                 CryptoPP::Integer w(&wBroadcast.body()[offset], 32);
@@ -676,7 +683,7 @@ int FairnessProtocol::proofKnowledge() {
                 // Add all the original commitments at this slice and the permutated slot
                 CryptoPP::ECPPoint sumC;
                 for (uint32_t share = 0; share < k_; share++) {
-                    sumC = curve_.GetCurve().Add(sumC, commitments_[wBroadcast.senderID()][slot][share][slice]);
+                    sumC = curve_.GetCurve().Add(sumC, commitments_[memberIndex][slot][share][slice]);
                 }
 
                 // Retrieve r'G by calculating C' + Inv(C) = C' - C = (r+r')G + xH - (rG + xH) = r'G
@@ -18,7 +18,7 @@ enum Outcome {
 class FairnessProtocol : public DCState {
 public:
     FairnessProtocol(DCNetwork& DCNet, size_t numSlices, size_t slotIndex, std::vector<std::vector<std::vector<CryptoPP::Integer>>> rValues,
-            std::unordered_map<uint32_t, std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>>> commitments);
+            std::vector<std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>>> commitments);
 
     virtual ~FairnessProtocol();
 
@@ -55,8 +55,8 @@ private:
 
     std::vector<std::vector<std::vector<CryptoPP::Integer>>> rValues_;
 
-    // initial commitments stored with the corresponding senderID
-    std::unordered_map<uint32_t, std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>>> commitments_;
+    // initial commitments indexed by the position of the sender in the member list
+    std::vector<std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>>> commitments_;
 
     std::unordered_map<uint32_t, std::vector<std::vector<CryptoPP::ECPPoint>>> newCommitments_;
 
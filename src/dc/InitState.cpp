@@ -1,33 +1,181 @@
 
+#include <iostream>
 #include <thread>
+#include <set>
+#include <algorithm>
+#include <cryptopp/osrng.h>
+#include <cryptopp/sha.h>
 #include "DCNetwork.h"
 #include "InitState.h"
 #include "../datastruct/MessageType.h"
 #include "SecuredInitialRound.h"
 #include "UnsecuredInitialRound.h"
 
+// random bytes, which each member contributes to the nonce of the group
+const size_t NONCE_CONTRIBUTION_SIZE = 16;
+
+// time in milliseconds the members of a restarted group wait for each other
+const uint32_t SYNCHRONIZATION_TIMEOUT = 1000;
+
 InitState::InitState(DCNetwork& DCNet) : DCNetwork_(DCNet) {}
 
 InitState::~InitState() {}
 
 std::unique_ptr<DCState> InitState::executeTask() {
-    while (DCNetwork_.members().size() < DCNetwork_.k()) {
-        auto receivedMessage = DCNetwork_.inbox().pop();
+    for (;;) {
+        while (DCNetwork_.members().size() < DCNetwork_.k()) {
+            auto receivedMessage = DCNetwork_.inbox().pop();
+
+            while((receivedMessage.msgType() != DCConnect) && (receivedMessage.msgType() != DCConnectResponse)) {
+                DCNetwork_.inbox().push(receivedMessage);
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                receivedMessage = DCNetwork_.inbox().pop();
+            }
+
+            uint32_t nodeID = receivedMessage.senderID();
+            DCMember member(nodeID, receivedMessage.connectionID(), DCNetwork_.neighbors()[nodeID].publicKey());
+            member.pairwiseSeed(DCNetwork_.deriveSeed(member.publicKey()));
+            DCNetwork_.members().insert(std::make_pair(receivedMessage.senderID(), member));
+        }
+
+        if (InitState::synchronize())
+            break;
+
+        // the members could not agree on the excluded members,
+        // the convicted members are removed without shrinking the group, which waits for new members
+        std::cout << "Node " << DCNetwork_.nodeID() << ": the members disagree on the excluded members, "
+                  << "falling back to the regular recovery" << std::endl;
+        DCNetwork_.discardExclusions();
+    }
+    DCNetwork_.updateMemberTable();
+
+    // perform a state transition
+    return InitState::initialRound(DCNetwork_);
+}
+
+bool InitState::synchronize() {
+    // the group this node continues with, the convicted members are excluded in the fast recovery mode
+    std::set<uint32_t> convictedMembers = DCNetwork_.convictedMembers();
+    std::vector<uint32_t> group;
+    for (auto& member : DCNetwork_.members())
+        if (convictedMembers.count(member.first) == 0)
+            group.push_back(member.first);
+
+    // the epoch counters diverge if the members took different paths through the protocol
+    uint64_t epoch = DCNetwork_.epoch();
+    // the members which detected a disrupted hybrid payload continue with committed payloads
+    uint64_t hybridFallbackEpoch = DCNetwork_.hybridFallbackEpoch();
+    std::vector<uint8_t> body(16 + NONCE_CONTRIBUTION_SIZE + 4 + 4 * group.size());
+    for (uint32_t i = 0; i < 8; i++) {
+        body[i] = (epoch >> (56 - 8 * i)) & 0xFF;
+        body[8 + i] = (hybridFallbackEpoch >> (56 - 8 * i)) & 0xFF;
+    }
+
+    // each member contributes to the nonce of the group
+    CryptoPP::AutoSeededRandomPool PRNG;
+    PRNG.GenerateBlock(&body[16], NONCE_CONTRIBUTION_SIZE);
+    std::map<uint32_t, std::vector<uint8_t>> contributions;
+    contributions[DCNetwork_.nodeID()] = std::vector<uint8_t>(&body[16], &body[16 + NONCE_CONTRIBUTION_SIZE]);
+
+    // the node IDs of the group in ascending order
+    uint32_t offset = 16 + NONCE_CONTRIBUTION_SIZE;
+    uint32_t groupSize = group.size();
+    for (uint32_t i = 0; i < 4; i++)
+        body[offset + i] = (groupSize >> (24 - 8 * i)) & 0xFF;
+    for (uint32_t member = 0; member < group.size(); member++)
+        for (uint32_t i = 0; i < 4; i++)
+            body[offset + 4 + 4 * member + i] = (group[member] >> (24 - 8 * i)) & 0xFF;
+
+    std::set<uint32_t> remainingMembers;
+    for (uint32_t memberID : group) {
+        if (memberID == DCNetwork_.nodeID())
+            continue;
 
-        while((receivedMessage.msgType() != DCConnect) && (receivedMessage.msgType() != DCConnectResponse)) {
+        OutgoingMessage syncMessage(DCNetwork_.members().at(memberID).connectionID(), GroupSynchronization,
+                                    DCNetwork_.nodeID(), body);
+        DCNetwork_.outbox().push(std::move(syncMessage));
+        remainingMembers.insert(memberID);
+    }
+
+    // a restarted group has been running before, therefore all members are expected to respond in time
+    bool restart = DCNetwork_.fastRecovery() && DCNetwork_.memberTable();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(SYNCHRONIZATION_TIMEOUT);
+
+    bool agreed = true;
+    while (!remainingMembers.empty()) {
+        ReceivedMessage receivedMessage;
+        if (!restart)
+            receivedMessage = DCNetwork_.inbox().pop();
+        else if (!DCNetwork_.inbox().pop(receivedMessage, deadline)) {
+            agreed = false;
+            break;
+        }
+
+        if (receivedMessage.msgType() != GroupSynchronization) {
             DCNetwork_.inbox().push(receivedMessage);
             std::this_thread::sleep_for(std::chrono::milliseconds(5));
-            receivedMessage = DCNetwork_.inbox().pop();
+            continue;
+        }
+
+        // each member of the group is counted once
+        std::vector<uint8_t>& syncBody = receivedMessage.body();
+        uint32_t senderID = receivedMessage.senderID();
+        if ((syncBody.size() < offset + 4) || (remainingMembers.count(senderID) == 0)
+            || (DCNetwork_.members().at(senderID).connectionID() != receivedMessage.connectionID()))
+            continue;
+        remainingMembers.erase(senderID);
+
+        uint64_t memberEpoch = 0;
+        uint64_t memberFallbackEpoch = 0;
+        for (uint32_t i = 0; i < 8; i++) {
+            memberEpoch = (memberEpoch << 8) | syncBody[i];
+            memberFallbackEpoch = (memberFallbackEpoch << 8) | syncBody[8 + i];
         }
+        epoch = std::max(epoch, memberEpoch);
+        hybridFallbackEpoch = std::max(hybridFallbackEpoch, memberFallbackEpoch);
 
-        uint32_t nodeID = receivedMessage.senderID();
-        DCMember member(nodeID, receivedMessage.connectionID(), DCNetwork_.neighbors()[nodeID].publicKey());
-        DCNetwork_.members().insert(std::make_pair(receivedMessage.senderID(), member));
+        contributions[receivedMessage.senderID()] = std::vector<uint8_t>(&syncBody[16],
+                                                                         &syncBody[16 + NONCE_CONTRIBUTION_SIZE]);
+
+        // in the fast recovery mode all members have to continue with the same group
+        if (DCNetwork_.fastRecovery()
+            && !std::equal(body.begin() + offset, body.end(), syncBody.begin() + offset, syncBody.end()))
+            agreed = false;
     }
+    if (!agreed)
+        return false;
 
-    // perform a state transition
-    if(DCNetwork_.securityLevel() == Secured || DCNetwork_.securityLevel() == ProofOfFairness)
-        return std::make_unique<SecuredInitialRound>(DCNetwork_);
+    DCNetwork_.applyExclusions();
+    DCNetwork_.resumeEpoch(epoch);
+    DCNetwork_.fallBackToCommittedPayloads(hybridFallbackEpoch);
+
+    // the contributions are hashed in the order of the node IDs
+    std::array<uint8_t, 32> groupNonce;
+    CryptoPP::SHA256 sha256;
+    for (auto& contribution : contributions)
+        sha256.Update(contribution.second.data(), contribution.second.size());
+    sha256.Final(groupNonce.data());
+    DCNetwork_.rekey(groupNonce);
+    return true;
+}
+
+std::unique_ptr<DCState> InitState::recover(DCNetwork& DCNet, uint64_t epoch) {
+    if (DCNet.fastRecovery())
+        return std::make_unique<InitState>(DCNet);
+
+    // wait for the remaining messages of the round
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    DCNet.inbox(epoch).clear();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    return std::make_unique<InitState>(DCNet);
+}
+
+std::unique_ptr<DCState> InitState::initialRound(DCNetwork& DCNet) {
+    if(DCNet.securityLevel() == Secured || DCNet.securityLevel() == ProofOfFairness
+       || DCNet.securityLevel() == Hybrid)
+        return std::make_unique<SecuredInitialRound>(DCNet);
+    else if((DCNet.securityLevel() == Adaptive) && (DCNet.adaptiveSecurity().level() != AdaptiveUnsecured))
+        return std::make_unique<SecuredInitialRound>(DCNet);
     else
-        return std::make_unique<UnsecuredInitialRound>(DCNetwork_);
+        return std::make_unique<UnsecuredInitialRound>(DCNet);
 }
\ No newline at end of file
@@ -4,6 +4,10 @@
 //#include "DCNetwork.h"
 #include "DCState.h"
 
+// time in milliseconds an aborted round keeps validating blame messages in the fast recovery mode,
+// so that all members convict the same members
+const uint32_t BLAME_COLLECTION_TIME = 50;
+
 class InitState : public DCState {
 public:
     InitState(DCNetwork& DCNet);
@@ -12,7 +16,20 @@ public:
 
     virtual std::unique_ptr<DCState> executeTask();
 
+    // selects the initial round according to the security level
+    static std::unique_ptr<DCState> initialRound(DCNetwork& DCNet);
+
+    // transition after an aborted secured round,
+    // in the fast recovery mode the remaining messages of the round are left in the inbox of its epoch
+    static std::unique_ptr<DCState> recover(DCNetwork& DCNet, uint64_t epoch);
+
 private:
+    // exchanges the local epoch, a nonce contribution and the remaining members with the group,
+    // the group continues with the highest epoch and rekeys its pads with the combined nonce.
+    // In the fast recovery mode the convicted members are excluded only if all remaining members
+    // continue with the same group, false if they disagree or do not respond in time
+    bool synchronize();
+
     DCNetwork& DCNetwork_;
 };
 
@@ -0,0 +1,38 @@
+#include <algorithm>
+#include "MemberTable.h"
+
+MemberTable::MemberTable(std::map<uint32_t, DCMember>& members) {
+    nodeIDs_.reserve(members.size());
+    connectionIDs_.reserve(members.size());
+    publicKeys_.reserve(members.size());
+
+    for (auto& member : members) {
+        nodeIDs_.push_back(member.first);
+        connectionIDs_.push_back(member.second.connectionID());
+        publicKeys_.push_back(member.second.publicKey());
+    }
+}
+
+uint32_t MemberTable::size() const {
+    return nodeIDs_.size();
+}
+
+int MemberTable::index(uint32_t nodeID) const {
+    auto position = std::lower_bound(nodeIDs_.begin(), nodeIDs_.end(), nodeID);
+    if ((position == nodeIDs_.end()) || (*position != nodeID))
+        return -1;
+
+    return position - nodeIDs_.begin();
+}
+
+uint32_t MemberTable::nodeID(uint32_t index) const {
+    return nodeIDs_[index];
+}
+
+uint32_t MemberTable::connectionID(uint32_t index) const {
+    return connectionIDs_[index];
+}
+
+const CryptoPP::ECPPoint& MemberTable::publicKey(uint32_t index) const {
+    return publicKeys_[index];
+}
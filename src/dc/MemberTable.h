@@ -0,0 +1,37 @@
+#ifndef THREEPP_MEMBERTABLE_H
+#define THREEPP_MEMBERTABLE_H
+
+#include <cstdint>
+#include <map>
+#include <vector>
+#include <cryptopp/ecpoint.h>
+#include "DCMember.h"
+
+// Immutable snapshot of the ordered member list.
+// The members are addressed by their position in the list, which is shared by all members of the group.
+class MemberTable {
+public:
+    MemberTable(std::map<uint32_t, DCMember>& members);
+
+    uint32_t size() const;
+
+    // position of the node in the ordered member list, -1 if the node is not a member
+    int index(uint32_t nodeID) const;
+
+    uint32_t nodeID(uint32_t index) const;
+
+    uint32_t connectionID(uint32_t index) const;
+
+    const CryptoPP::ECPPoint& publicKey(uint32_t index) const;
+
+private:
+    // sorted in the order of the member map, which allows a binary search for the position
+    std::vector<uint32_t> nodeIDs_;
+
+    std::vector<uint32_t> connectionIDs_;
+
+    std::vector<CryptoPP::ECPPoint> publicKeys_;
+};
+
+
+#endif //THREEPP_MEMBERTABLE_H
@@ -2,6 +2,8 @@
 #include <cryptopp/oids.h>
 #include <thread>
 #include <iomanip>
+#include <algorithm>
+#include <set>
 #include "SecuredFinalRound.h"
 #include "InitState.h"
 #include "../datastruct/MessageType.h"
@@ -9,34 +11,81 @@
 #include "../utils/Utils.h"
 #include "BlameRound.h"
 #include "../ad/VirtualSource.h"
+#include "SeededShares.h"
+#include "SpotCheck.h"
+#include "BlameMessage.h"
+#include "AsyncVerifier.h"
 
 std::mutex loggingMutex;
 
-SecuredFinalRound::SecuredFinalRound(DCNetwork &DCNet, int slotIndex, std::vector<std::pair<uint16_t, uint16_t>> slots,
-                                     std::vector<CryptoPP::Integer> seedPrivateKeys,
-                                     std::vector<std::array<uint8_t, 32>> receivedSeeds)
-        : DCNetwork_(DCNet), k_(DCNetwork_.k()), slotIndex_(slotIndex), slots_(std::move(slots)),
-          seedPrivateKeys_(seedPrivateKeys), seeds_(std::move(receivedSeeds)), rValues_(k_) {
-
-    if(!DCNet.fullProtocol())
-        delayedVerification_ = true;
+// length of the payload (2 bytes) followed by its SHA-256 digest
+const uint16_t DIGEST_SLOT_SIZE = 34;
+
+// number of epochs with fully committed payloads after a payload did not match its digest
+const uint64_t HYBRID_FALLBACK_EPOCHS = 10;
+
+SecuredFinalRound::SecuredFinalRound(DCNetwork &DCNet, std::vector<int> slotIndices,
+                                     std::vector<std::pair<uint16_t, uint16_t>> slots,
+                                     std::vector<std::vector<CryptoPP::Integer>> seedPrivateKeys,
+                                     std::vector<std::array<uint8_t, 32>> receivedSeeds, uint64_t epoch,
+                                     uint32_t leasedRounds)
+        : DCNetwork_(DCNet), members_(DCNet.memberTable()), k_(DCNetwork_.k()),
+          epoch_(epoch), slotIndices_(std::move(slotIndices)),
+          slots_(std::move(slots)), seedPrivateKeys_(std::move(seedPrivateKeys)), seeds_(std::move(receivedSeeds)), rValues_(k_),
+          delayedVerification_(!DCNet.fullProtocol()), auditedSlices_(0),
+          optimistic_(DCNet.optimisticCommitments() && !DCNet.fullProtocol()),
+          hybrid_(DCNet.hybridPayloads(epoch)), leaseSize_(DCNet.leaseSize()),
+          leasedRounds_(leasedRounds) {
+
+    if (DCNet.speculativeVerification() && !delayedVerification_)
+        verifier_ = std::make_unique<AsyncVerifier>(DCNet.numThreads());
+
+    // in the hybrid mode the secured round transmits only the digests of the payloads
+    if (hybrid_) {
+        payloadSlots_ = slots_;
+        for (auto &slot : slots_)
+            slot.first = DIGEST_SLOT_SIZE;
+    }
 
     curve.Initialize(CryptoPP::ASN1::secp256k1());
 
     // determine the index of the own nodeID in the ordered member list
-    nodeIndex_ = std::distance(DCNetwork_.members().begin(), DCNetwork_.members().find(DCNetwork_.nodeID()));
+    nodeIndex_ = members_->index(DCNetwork_.nodeID());
 
     R.resize(slots_.size());
+    if (DCNetwork_.seededShares())
+        shares_.resize(slots_.size());
+
+    size_t maxSlices = 0;
     for (uint32_t slot = 0; slot < slots_.size(); slot++) {
         rValues_[slot].resize(k_);
-        DRNG.SetKeyWithIV(seeds_[slot].data(), 16, seeds_[slot].data() + 16, 16);
-
         size_t numSlices = std::ceil((4 + slots_[slot].first) / 31.0);
-        R[slot].resize(numSlices);
+        maxSlices = std::max(maxSlices, numSlices);
+
+        // a vector commitment requires only a single blinding factor per share
+        size_t numCommitments = DCNetwork_.vectorCommitments() ? 1 : numSlices;
+        R[slot].resize(numCommitments);
+
+        if (DCNetwork_.seededShares()) {
+            // expand the shares for the other members and all blinding factors from the share seeds,
+            // the own share is computed as remainder in the preparation
+            shares_[slot].resize(k_);
+            for (uint32_t share = 0; share < k_; share++) {
+                SeededShares::expand(SeededShares::shareSeed(seeds_[slot], share), numSlices, curve.GetMaxExponent(),
+                                     rValues_[slot][share], share != nodeIndex_ ? &shares_[slot][share] : nullptr);
+                rValues_[slot][share].resize(numCommitments);
+            }
+            for (uint32_t slice = 0; slice < numCommitments; slice++)
+                R[slot][slice] = rValues_[slot][nodeIndex_][slice];
+
+            continue;
+        }
+
+        DRNG.SetKeyWithIV(seeds_[slot].data(), 16, seeds_[slot].data() + 16, 16);
         for (uint32_t share = 0; share < k_; share++) {
-            rValues_[slot][share].reserve(numSlices);
+            rValues_[slot][share].reserve(numCommitments);
 
-            for (uint32_t slice = 0; slice < numSlices; slice++) {
+            for (uint32_t slice = 0; slice < numCommitments; slice++) {
                 CryptoPP::Integer r(DRNG, CryptoPP::Integer::One(), curve.GetMaxExponent());
                 rValues_[slot][share].push_back(std::move(r));
 
@@ -45,6 +94,9 @@ SecuredFinalRound::SecuredFinalRound(DCNetwork &DCNet, int slotIndex, std::vecto
             }
         }
     }
+
+    if (DCNetwork_.vectorCommitments())
+        generators_ = VectorCommitment::generators(maxSlices);
 }
 
 SecuredFinalRound::~SecuredFinalRound() {}
@@ -55,6 +107,18 @@ std::unique_ptr<DCState> SecuredFinalRound::executeTask() {
     // generate the shares
     SecuredFinalRound::preparation();
 
+    // the initial round of the next epoch is executed alongside this round,
+    // it is started after the preparation, which removes the own message from the submitted messages.
+    // If this round fails, the future still waits for the initial round on destruction.
+    std::unique_ptr<DCState> nextInitialRound;
+    std::future<std::unique_ptr<DCState>> nextState;
+    if (DCNetwork_.pipelining() && (DCNetwork_.securityLevel() != Adaptive)) {
+        nextInitialRound = std::make_unique<SecuredInitialRound>(DCNetwork_);
+        nextState = std::async(std::launch::async, [&nextInitialRound]() {
+            return nextInitialRound->executeTask();
+        });
+    }
+
     auto finished = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> elapsed = finished - start;
     runtimes.push_back(elapsed.count());
@@ -72,10 +136,7 @@ std::unique_ptr<DCState> SecuredFinalRound::executeTask() {
     int result = SecuredFinalRound::sharingPartTwo();
     // a blame message has been received
     if (result < 0) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
-        DCNetwork_.inbox().clear();
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
-        return std::make_unique<InitState>(DCNetwork_);
+        return SecuredFinalRound::abortRound();
     }
     finished = std::chrono::high_resolution_clock::now();
     elapsed = finished - start;
@@ -86,67 +147,82 @@ std::unique_ptr<DCState> SecuredFinalRound::executeTask() {
     std::vector<std::vector<uint8_t>> finalMessages = SecuredFinalRound::resultComputation();
 
     if (finalMessages.size() == 0) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
-        DCNetwork_.inbox().clear();
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
-        return std::make_unique<InitState>(DCNetwork_);
+        return SecuredFinalRound::abortRound();
+    }
+
+    // both sharings contain the slices of all slots from (k-1) members
+    if (delayedVerification_ && (DCNetwork_.auditRate() > 0)) {
+        uint64_t receivedSlices = 0;
+        for (auto &slot : S)
+            receivedSlices += 2 * (k_ - 1) * slot.size();
+        DCNetwork_.recordAudit(auditedSlices_, receivedSlices);
     }
 
     // Verify the CRCs
     for(uint32_t slot = 0; slot < finalMessages.size(); slot++) {
         CRC32_.Update(&finalMessages[slot][4], finalMessages[slot].size() - 4);
         bool valid = CRC32_.Verify(finalMessages[slot].data());
-        // if there is a CRC error in the own slot,
-        // check which commitments don't add up to zero
-        if(!valid && (static_cast<int>(slot) == slotIndex_)) {
-            for (auto it = DCNetwork_.members().begin(); it != DCNetwork_.members().end(); it++) {
-                uint32_t memberIndex = std::distance(DCNetwork_.members().begin(), it);
 
+        // the victim check and the blame round require the full commitments
+        if (!valid && optimistic_ && (SecuredFinalRound::revealCommitments() < 0)) {
+            return SecuredFinalRound::abortRound();
+        }
+        if (!valid && delayedVerification_)
+            SecuredFinalRound::decodeCommitments();
+        // if there is a CRC error in an own slot,
+        // check which commitments don't add up to zero
+        auto reservation = std::find(slotIndices_.begin(), slotIndices_.end(), static_cast<int>(slot));
+        if(!valid && (reservation != slotIndices_.end())) {
+            std::vector<CryptoPP::Integer>& seedPrivateKeys = seedPrivateKeys_[reservation - slotIndices_.begin()];
+            for (uint32_t memberIndex = 0; memberIndex < k_; memberIndex++) {
                 if (memberIndex != nodeIndex_) {
-                    size_t numSlices = S[slotIndex_].size();
+                    size_t numSlices = S[slot].size();
+                    size_t numCommitments = R[slot].size();
 
-                    CryptoPP::Integer sharedSecret = curve.GetCurve().ScalarMultiply(it->second.publicKey(),
-                                                                                     seedPrivateKeys_[memberIndex]).x;
+                    CryptoPP::Integer sharedSecret = curve.GetCurve().ScalarMultiply(members_->publicKey(memberIndex),
+                                                                                     seedPrivateKeys[memberIndex]).x;
 
                     std::array<uint8_t, 32> seed;
                     sharedSecret.Encode(seed.data(), 32);
 
-                    DRNG.SetKeyWithIV(seed.data(), 16, seed.data() + 16, 16);
-
                     // calculate the rValues
                     std::vector<std::vector<CryptoPP::Integer>> rValues;
-                    rValues.reserve(k_);
+                    if (DCNetwork_.seededShares()) {
+                        rValues.resize(k_);
+                        for (uint32_t share = 0; share < k_; share++) {
+                            SeededShares::expand(SeededShares::shareSeed(seed, share), numSlices,
+                                                 curve.GetMaxExponent(), rValues[share]);
+                            rValues[share].resize(numCommitments);
+                        }
+                    } else {
+                        DRNG.SetKeyWithIV(seed.data(), 16, seed.data() + 16, 16);
+                        rValues.reserve(k_);
 
-                    for (uint32_t share = 0; share < k_; share++) {
-                        std::vector<CryptoPP::Integer> rValuesShare;
-                        rValuesShare.reserve(numSlices);
-                        for (uint32_t slice = 0; slice < numSlices; slice++) {
-                            CryptoPP::Integer r(DRNG, CryptoPP::Integer::One(), curve.GetMaxExponent());
-                            rValuesShare.push_back(std::move(r));
+                        for (uint32_t share = 0; share < k_; share++) {
+                            std::vector<CryptoPP::Integer> rValuesShare;
+                            rValuesShare.reserve(numCommitments);
+                            for (uint32_t slice = 0; slice < numCommitments; slice++) {
+                                CryptoPP::Integer r(DRNG, CryptoPP::Integer::One(), curve.GetMaxExponent());
+                                rValuesShare.push_back(std::move(r));
+                            }
+                            rValues.push_back(std::move(rValuesShare));
                         }
-                        rValues.push_back(std::move(rValuesShare));
                     }
 
-                    for (uint32_t slice = 0; slice < numSlices; slice++) {
+                    for (uint32_t slice = 0; slice < numCommitments; slice++) {
                         CryptoPP::ECPPoint C_;
                         CryptoPP::Integer R_;
                         for (uint32_t share = 0; share < k_; share++) {
-                            C_ = curve.GetCurve().Add(C_, commitments_[memberIndex][slotIndex_][share][slice]);
+                            C_ = curve.GetCurve().Add(C_, commitments_[memberIndex][slot][share][slice]);
                             R_ += rValues[share][slice];
                         }
                         R_ = R_.Modulo(curve.GetGroupOrder());
 
-                        // create the commitment
-                        CryptoPP::Integer S_(CryptoPP::Integer::Zero());
-                        CryptoPP::ECPPoint rG = curve.GetCurve().ScalarMultiply(G, R_);
-                        CryptoPP::ECPPoint sH = curve.GetCurve().ScalarMultiply(H, S_);
-                        CryptoPP::ECPPoint commitment = curve.GetCurve().Add(rG, sH);
-
-                        // validate the commitment
-                        if ((C_.x != commitment.x) || (C_.y != commitment.y)) {
+                        // validate the commitment, the shares of an unused slot add up to zero
+                        if (!SpotCheck::opens(curve, C_, R_, CryptoPP::Integer::Zero())) {
                             // Switch to the blame protocol as a victim
-                            return std::make_unique<BlameRound>(DCNetwork_, slotIndex_, slice, it->first,
-                                                                seedPrivateKeys_[memberIndex], commitments_);
+                            return std::make_unique<BlameRound>(DCNetwork_, slot, slice, members_->nodeID(memberIndex),
+                                                                seedPrivateKeys[memberIndex], commitments_);
                         }
                     }
                 }
@@ -158,6 +234,28 @@ std::unique_ptr<DCState> SecuredFinalRound::executeTask() {
         }
     }
 
+    // transmit the payloads and verify them against the digests of the secured round
+    if (hybrid_) {
+        SecuredFinalRound::payloadSharing();
+        SecuredFinalRound::payloadComputation();
+
+        bool matches = true;
+        for (uint32_t slot = 0; slot < finalMessages.size(); slot++) {
+            if (!SecuredFinalRound::payloadMatches(slot, finalMessages[slot])) {
+                std::cout << "Payload does not match the committed digest" << std::endl;
+                matches = false;
+            }
+        }
+
+        // the digests of the secured round are valid, therefore a blame round would not find the disruptor,
+        // instead the group repeats the round and transmits the payloads with commitments for a while
+        if (!SecuredFinalRound::agreeOnPayloads(matches)) {
+            DCNetwork_.fallBackToCommittedPayloads(epoch_ + HYBRID_FALLBACK_EPOCHS);
+            return SecuredFinalRound::abortRound();
+        }
+        finalMessages = std::move(payloads_);
+    }
+
     // Logging
     if (DCNetwork_.logging()) {
         finished = std::chrono::high_resolution_clock::now();
@@ -175,7 +273,8 @@ std::unique_ptr<DCState> SecuredFinalRound::executeTask() {
         // round 2
         log[4 * sizeof(double) + 1] = 2;
         //sending
-        log[4 * sizeof(double) + 2] = (slotIndex_ > -1) ? 1 : 0;
+        log[4 * sizeof(double) + 2] = std::any_of(slotIndices_.begin(), slotIndices_.end(),
+                                                  [](int slotIndex) { return slotIndex > -1; }) ? 1 : 0;
         //numThreads
         log[4 * sizeof(double) + 3] = DCNetwork_.numThreads();
 
@@ -183,37 +282,28 @@ std::unique_ptr<DCState> SecuredFinalRound::executeTask() {
         DCNetwork_.outbox().push(std::move(logMessage));
     }
 
-    // print the reconstructed message slots
-    {
-        std::lock_guard<std::mutex> lock(loggingMutex);
-        std::cout << "Node " << std::dec << DCNetwork_.nodeID() << " received messages:" << std::endl;
-        for (auto &slot : finalMessages) {
-            std::string msgHash = utils::sha256(slot);
-            std::cout << "|";
-            for (uint8_t c : msgHash) {
-                std::cout << std::hex << std::setw(2) << std::setfill('0') << (int) c;
-            }
-            std::cout << "|" << std::endl;
-        }
-        std::cout << std::endl;
+    // deliver the slots, which have not been delivered as soon as they were complete
+    for (uint32_t t = 0; t < finalMessages.size(); t++) {
+        if (deliveredSlots_.empty() || !deliveredSlots_[t])
+            SecuredFinalRound::deliverSlot(t, finalMessages[t]);
     }
 
-    // pass the final message through the message handler to store it in the message buffer
-    for (uint32_t t = 0; t < finalMessages.size(); t++) {
-        std::vector<uint8_t> message(finalMessages[t].begin() + 4, finalMessages[t].end());
-        OutgoingMessage finalMessage(SELF, DCNetworkReceived, SELF, std::move(message));
-        DCNetwork_.outbox().push(std::move(finalMessage));
-
-        // check if a VS Token has to be generated for this message by this node
-        if(DCNetwork_.AD() && (slots_[t].second >= nodeIndex_*65535/k_) && (slots_[t].second < (nodeIndex_+1)*65535/k_)) {
-            std::lock_guard<std::mutex> lock(loggingMutex);
-            std::cout << "Node " << nodeIndex_ << "Generating VS Token for slot " << t << std::endl;
-            std::vector<uint8_t> VSToken = VirtualSource::generateVSToken(0, 0, message);
-            OutgoingMessage vsForward(SELF, VirtualSourceToken, DCNetwork_.nodeID(), VSToken);
-            DCNetwork_.outbox().push(vsForward);
-        }
+    // return to the unsecured rounds after enough clean rounds
+    if (DCNetwork_.securityLevel() == Adaptive) {
+        DCNetwork_.adaptiveSecurity().cleanRound();
+        return InitState::initialRound(DCNetwork_);
     }
 
+    // continue with the successor of the pipelined initial round
+    if (nextState.valid())
+        return nextState.get();
+
+    // skip the reservation round if any slot has been renewed
+    if (leaseSize_ > 0) {
+        std::unique_ptr<DCState> nextRound = SecuredFinalRound::leasedRound(finalMessages);
+        if (nextRound)
+            return nextRound;
+    }
     return std::make_unique<SecuredInitialRound>(DCNetwork_);
 }
 
@@ -226,62 +316,134 @@ void SecuredFinalRound::preparation() {
     for (uint32_t i = 0; i < numSlots; i++)
         numSlices.push_back(std::ceil((4 + slots_[i].first) / 31.0));
 
-    std::vector<CryptoPP::Integer> messageSlices;
+    // slices of the own message slots
+    std::vector<std::vector<CryptoPP::Integer>> messageSlices(numSlots);
+
+    if (hybrid_) {
+        payloads_.resize(numSlots);
+        for (uint32_t slot = 0; slot < numSlots; slot++)
+            payloads_[slot].resize(4 + payloadSlots_[slot].first);
+    }
+
+    // the leases are renewed for the messages which remain in the queue after this round,
+    // a fresh reservation round is enforced after the maximum number of leased rounds
+    std::vector<size_t> remainingMessages;
+    if ((leaseSize_ > 0) && (leasedRounds_ < DCNetwork_.leaseRounds())) {
+        for (uint32_t reservation = 0; reservation < slotIndices_.size(); reservation++) {
+            if (slotIndices_[reservation] < 0)
+                remainingMessages.push_back(reservation);
+        }
+        for (size_t i = slotIndices_.size(); i < DCNetwork_.submittedMessages().size(); i++)
+            remainingMessages.push_back(i);
+    }
+
+    for (uint32_t reservation = 0; reservation < slotIndices_.size(); reservation++) {
+        int slotIndex = slotIndices_[reservation];
+        if (slotIndex < 0)
+            continue;
+
+        std::vector<uint8_t> submittedMessage = DCNetwork_.submittedMessages()[reservation];
+
+        // prepend the lease header, which is left empty if the lease is not renewed
+        if (leaseSize_ > 0) {
+            std::vector<uint8_t> lease(leaseSize_);
+            if (renewedSlots_.size() < remainingMessages.size()) {
+                size_t nextMessage = remainingMessages[renewedSlots_.size()];
+                SecuredFinalRound::writeLease(lease.data(), DCNetwork_.submittedMessages()[nextMessage].size());
+                renewedSlots_.push_back(slotIndex);
+            }
+            submittedMessage.insert(submittedMessage.begin(), lease.begin(), lease.end());
+        }
 
-    if (slotIndex_ > -1) {
-        std::vector<uint8_t> submittedMessage = DCNetwork_.submittedMessages().front();
-        DCNetwork_.submittedMessages().pop();
+        if (hybrid_) {
+            // the payload is transmitted in the padded payload slot
+            std::vector<uint8_t>& payloadSlot = payloads_[slotIndex];
+            CRC32_.Update(submittedMessage.data(), payloadSlots_[slotIndex].first);
+            CRC32_.Final(payloadSlot.data());
+            std::copy(submittedMessage.begin(), submittedMessage.end(), &payloadSlot[4]);
+
+            // replace the message by its length and digest
+            std::array<uint8_t, 32> digest = utils::sha256Digest(submittedMessage);
+            submittedMessage.resize(DIGEST_SLOT_SIZE);
+            submittedMessage[0] = (payloadSlots_[slotIndex].first & 0xFF00) >> 8;
+            submittedMessage[1] = (payloadSlots_[slotIndex].first & 0x00FF);
+            std::copy(digest.begin(), digest.end(), &submittedMessage[2]);
+        }
 
         // Split the submitted message into slices of 31 Bytes
-        messageSlices.reserve(numSlices[slotIndex_]);
+        messageSlices[slotIndex].reserve(numSlices[slotIndex]);
 
-        std::vector<uint8_t> messageSlot(4 + slots_[slotIndex_].first);
+        std::vector<uint8_t> messageSlot(4 + slots_[slotIndex].first);
         // Calculate the CRC
-        CRC32_.Update(submittedMessage.data(), slots_[slotIndex_].first);
+        CRC32_.Update(submittedMessage.data(), slots_[slotIndex].first);
         CRC32_.Final(messageSlot.data());
 
         std::copy(submittedMessage.begin(), submittedMessage.end(), &messageSlot[4]);
 
-        for (uint32_t i = 0; i < numSlices[slotIndex_]; i++) {
+        for (uint32_t i = 0; i < numSlices[slotIndex]; i++) {
             size_t sliceSize = ((messageSlot.size() - 31 * i > 31) ? 31 : messageSlot.size() - 31 * i);
             CryptoPP::Integer slice(&messageSlot[31 * i], sliceSize);
-            messageSlices.push_back(std::move(slice));
+            messageSlices[slotIndex].push_back(std::move(slice));
         }
     }
 
+    // the messages of failed reservations remain in the queue for the next round
+    for (size_t i = slotIndices_.size(); i-- > 0;) {
+        if (slotIndices_[i] > -1)
+            DCNetwork_.submittedMessages().erase(DCNetwork_.submittedMessages().begin() + i);
+    }
+
+    // in the seeded mode the shares for the other members have already been expanded,
+    // the own share takes the remainder
+    bool seeded = DCNetwork_.seededShares();
+    uint32_t remainder = seeded ? nodeIndex_ : k_ - 1;
+
     shares_.resize(numSlots);
     for (uint32_t slot = 0; slot < numSlots; slot++) {
         shares_[slot].resize(k_);
 
-        // initialize the slices of the k-th share with zeroes
-        // except the slices of the own message slot
-        if (static_cast<uint32_t>(slotIndex_) == slot) {
+        // initialize the slices of the remainder share with zeroes
+        // except the slices of the own message slots
+        if (!messageSlices[slot].empty()) {
             for (uint32_t slice = 0; slice < numSlices[slot]; slice++)
-                shares_[slot][k_ - 1].push_back(messageSlices[slice]);
+                shares_[slot][remainder].push_back(messageSlices[slot][slice]);
         } else {
             for (uint32_t slice = 0; slice < numSlices[slot]; slice++)
-                shares_[slot][k_ - 1].push_back(CryptoPP::Integer::Zero());
+                shares_[slot][remainder].push_back(CryptoPP::Integer::Zero());
         }
 
-        // fill the first slices of the first k-1 shares with random values
-        // and subtract the values from the corresponding slices in the k-th share
-        for (uint32_t share = 0; share < k_ - 1; share++) {
+        // fill the slices of the other k-1 shares with random values
+        // and subtract the values from the corresponding slices in the remainder share
+        for (uint32_t share = 0; share < k_; share++) {
+            if (share == remainder)
+                continue;
+
+            if (seeded) {
+                for (uint32_t slice = 0; slice < numSlices[slot]; slice++)
+                    shares_[slot][remainder][slice] -= shares_[slot][share][slice];
+                continue;
+            }
+
             shares_[slot][share].reserve(numSlices[slot]);
 
             for (uint32_t slice = 0; slice < numSlices[slot]; slice++) {
                 CryptoPP::Integer r(PRNG, CryptoPP::Integer::One(), curve.GetMaxExponent());
-                // subtract the value from the corresponding slice in the k-th share
-                shares_[slot][k_ - 1][slice] -= r;
+                // subtract the value from the corresponding slice in the remainder share
+                shares_[slot][remainder][slice] -= r;
                 // store the random value in the slice of this share
                 shares_[slot][share].push_back(std::move(r));
             }
         }
 
-        // reduce the slices in the k-th share
+        // reduce the slices in the remainder share
         for (uint32_t slice = 0; slice < numSlices[slot]; slice++)
-            shares_[slot][k_ - 1][slice] = shares_[slot][k_ - 1][slice].Modulo(curve.GetGroupOrder());
+            shares_[slot][remainder][slice] = shares_[slot][remainder][slice].Modulo(curve.GetGroupOrder());
     }
 
+    // the payload slots are padded like in the unsecured final round
+    for (uint32_t slot = 0; slot < payloads_.size(); slot++)
+        DCNetwork_.applyPads(payloads_[slot].data(), payloads_[slot].size(), epoch_, FinalRoundPads, slot);
+
     // initialize the slices in the slots of the final share with the slices of the own share
     S.resize(numSlots);
 
@@ -293,12 +455,92 @@ void SecuredFinalRound::preparation() {
     }
 }
 
+void SecuredFinalRound::writeLease(uint8_t* lease, size_t messageSize) {
+    size_t size = leaseSize_ + messageSize;
+    uint16_t l = size > USHRT_MAX ? USHRT_MAX : size;
+    uint16_t r = PRNG.GenerateWord32(0, USHRT_MAX);
+
+    lease[0] = static_cast<uint8_t>((r & 0xFF00) >> 8);
+    lease[1] = static_cast<uint8_t>((r & 0x00FF));
+    lease[2] = static_cast<uint8_t>((l & 0xFF00) >> 8);
+    lease[3] = static_cast<uint8_t>((l & 0x00FF));
+
+    // fresh ephemeral seeds for the commitments of the next round
+    std::vector<CryptoPP::Integer> seedPrivateKeys;
+    seedPrivateKeys.reserve(k_);
+    if (DCNetwork_.compactReservation()) {
+        CryptoPP::Integer r(PRNG, CryptoPP::Integer::One(), curve.GetMaxExponent());
+        CryptoPP::ECPPoint rG = curve.ExponentiateBase(r);
+
+        curve.GetCurve().EncodePoint(&lease[4], rG, true);
+        seedPrivateKeys.assign(k_, r);
+    } else {
+        for (uint32_t memberIndex = 0; memberIndex < k_; memberIndex++) {
+            CryptoPP::Integer r(PRNG, CryptoPP::Integer::One(), curve.GetMaxExponent());
+            CryptoPP::ECPPoint rG = curve.ExponentiateBase(r);
+
+            curve.GetCurve().EncodePoint(&lease[4 + 33 * memberIndex], rG, true);
+            seedPrivateKeys.push_back(std::move(r));
+        }
+    }
+    leaseKeys_.push_back(std::move(seedPrivateKeys));
+}
+
+std::unique_ptr<DCState> SecuredFinalRound::leasedRound(std::vector<std::vector<uint8_t>>& finalMessages) {
+    std::vector<std::pair<uint16_t, uint16_t>> slots;
+    std::vector<std::array<uint8_t, 32>> receivedSeeds;
+
+    // the renewed slots keep their order
+    std::vector<int> positions(finalMessages.size(), -1);
+    for (uint32_t slot = 0; slot < finalMessages.size(); slot++) {
+        if (finalMessages[slot].size() < 4 + leaseSize_)
+            continue;
+
+        uint8_t* lease = &finalMessages[slot][4];
+        uint16_t round_identifier = (lease[0] << 8) | lease[1];
+        uint16_t slotSize = (lease[2] << 8) | lease[3];
+        if (slotSize < leaseSize_)
+            continue;
+
+        // extract the own seed of the slot
+        uint32_t keyIndex = DCNetwork_.compactReservation() ? 0 : nodeIndex_;
+        CryptoPP::ECPPoint rG;
+        if (!curve.GetCurve().DecodePoint(rG, &lease[4 + 33 * keyIndex], 33))
+            continue;
+
+        CryptoPP::Integer sharedSecret = curve.GetCurve().ScalarMultiply(rG, DCNetwork_.privateKey()).x;
+        std::array<uint8_t, 32> seed;
+        sharedSecret.Encode(seed.data(), 32);
+
+        positions[slot] = slots.size();
+        receivedSeeds.push_back(std::move(seed));
+        slots.push_back(std::pair(slotSize, round_identifier));
+    }
+
+    if (slots.empty())
+        return nullptr;
+
+    // the renewed leases are assigned to the submitted messages in the order of the queue
+    std::vector<int> slotIndices;
+    slotIndices.reserve(renewedSlots_.size());
+    for (uint32_t slot : renewedSlots_)
+        slotIndices.push_back(positions[slot]);
+
+    std::cout << "Node " << std::dec << DCNetwork_.nodeID() << ": " << slots.size() << " leased slots" << std::endl;
+
+    return std::make_unique<SecuredFinalRound>(DCNetwork_, std::move(slotIndices), std::move(slots),
+                                               std::move(leaseKeys_), std::move(receivedSeeds),
+                                               DCNetwork_.nextEpoch(), leasedRounds_ + 1);
+}
+
 void SecuredFinalRound::sharingPartOne() {
     size_t numSlots = slots_.size();
 
     size_t encodedPointSize = curve.GetCurve().EncodedPointSize(true);
 
     std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>> commitmentCube(numSlots);
+    if (optimistic_)
+        encodedCommitments_.resize(numSlots);
 
     std::mutex threadMutex;
     std::list<std::thread> threads_;
@@ -322,8 +564,9 @@ void SecuredFinalRound::sharingPartOne() {
                     }
                 }
                 size_t numSlices = S[slot].size();
+                size_t numCommitments = R[slot].size();
 
-                std::vector<uint8_t> encodedCommitments(2 + k_ * numSlices * encodedPointSize);
+                std::vector<uint8_t> encodedCommitments(2 + k_ * numCommitments * encodedPointSize);
                 encodedCommitments[0] = (slot & 0xFF00) >> 8;
                 encodedCommitments[1] = (slot & 0x00FF);
 
@@ -331,16 +574,24 @@ void SecuredFinalRound::sharingPartOne() {
 
                 uint32_t offset = 2;
                 for (uint32_t share = 0; share < k_; share++) {
-                    commitmentMatrix[share].reserve(numSlices);
-                    for (uint32_t slice = 0; slice < numSlices; slice++, offset += encodedPointSize) {
+                    commitmentMatrix[share].reserve(numCommitments);
 
-                        // generate the commitment for the j-th slice of the i-th share
-                        CryptoPP::ECPPoint rG = threadCurve.GetCurve().ScalarMultiply(G, rValues_[slot][share][slice]);
-                        CryptoPP::ECPPoint sH = threadCurve.GetCurve().ScalarMultiply(H, shares_[slot][share][slice]);
-                        CryptoPP::ECPPoint commitment = threadCurve.GetCurve().Add(rG, sH);
+                    if (DCNetwork_.vectorCommitments()) {
+                        // commit to all slices of the share at once
+                        commitmentMatrix[share].push_back(generators_->commit(threadCurve, rValues_[slot][share][0],
+                                                                              shares_[slot][share]));
 
-                        // store the commitment
-                        commitmentMatrix[share].push_back(std::move(commitment));
+                        threadCurve.GetCurve().EncodePoint(&encodedCommitments[offset], commitmentMatrix[share][0],
+                                                           true);
+                        offset += encodedPointSize;
+                        continue;
+                    }
+
+                    for (uint32_t slice = 0; slice < numSlices; slice++, offset += encodedPointSize) {
+
+                        // generate and store the commitment for the j-th slice of the i-th share
+                        commitmentMatrix[share].push_back(SpotCheck::commit(threadCurve, rValues_[slot][share][slice],
+                                                                            shares_[slot][share][slice]));
 
                         // compress the commitment and store in the given position in the vector
                         threadCurve.GetCurve().EncodePoint(&encodedCommitments[offset], commitmentMatrix[share][slice],
@@ -350,15 +601,24 @@ void SecuredFinalRound::sharingPartOne() {
                 std::lock_guard<std::mutex> lock(threadMutex);
                 commitmentCube[slot] = std::move(commitmentMatrix);
 
-                auto position = DCNetwork_.members().find(DCNetwork_.nodeID());
-                for (uint32_t member = 0; member < k_ - 1; member++) {
-                    position++;
-                    if (position == DCNetwork_.members().end())
-                        position = DCNetwork_.members().begin();
+                if (optimistic_) {
+                    // broadcast only the digest, the encoded commitments are revealed in case of a dispute
+                    std::array<uint8_t, 32> digest = utils::sha256Digest(encodedCommitments);
+                    encodedCommitments_[slot] = std::move(encodedCommitments);
+
+                    encodedCommitments.assign(2 + digest.size(), 0);
+                    encodedCommitments[0] = (slot & 0xFF00) >> 8;
+                    encodedCommitments[1] = (slot & 0x00FF);
+                    std::copy(digest.begin(), digest.end(), &encodedCommitments[2]);
+                }
+
+                for (uint32_t member = 1; member < k_; member++) {
+                    uint32_t memberIndex = (nodeIndex_ + member) % k_;
 
-                    OutgoingMessage commitBroadcast(position->second.connectionID(), FinalRoundCommitments,
+                    OutgoingMessage commitBroadcast(members_->connectionID(memberIndex),
+                                                    optimistic_ ? FinalRoundCommitmentDigest : FinalRoundCommitments,
                                                     DCNetwork_.nodeID(), encodedCommitments);
-                    DCNetwork_.outbox().push(std::move(commitBroadcast));
+                    DCNetwork_.send(std::move(commitBroadcast), epoch_);
                 }
             }
         });
@@ -366,18 +626,16 @@ void SecuredFinalRound::sharingPartOne() {
     }
 
     // prepare the commitment storage
-    for (auto member = DCNetwork_.members().begin(); member != DCNetwork_.members().end(); member++) {
-        if (member->first != DCNetwork_.nodeID()) {
-            std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>> commitmentCube(numSlots);
-
-            commitments_.insert(std::pair(member->second.nodeID(), std::move(commitmentCube)));
-        }
-    }
+    commitments_.assign(k_, std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>>(numSlots));
+    if (delayedVerification_)
+        rawCommitments_.assign(k_, std::vector<std::vector<uint8_t>>(numSlots));
+    if (optimistic_)
+        commitmentDigests_.assign(k_, std::vector<std::array<uint8_t, 32>>(numSlots));
 
     for (auto &t : threads_)
         t.join();
 
-    commitments_.insert(std::pair(DCNetwork_.nodeID(), std::move(commitmentCube)));
+    commitments_[nodeIndex_] = std::move(commitmentCube);
 
     // collect the commitments from the other k-1 members
     threads_.clear();
@@ -395,22 +653,36 @@ void SecuredFinalRound::sharingPartOne() {
                     else
                         break;
                 }
-                auto commitBroadcast = DCNetwork_.inbox().pop();
+                auto commitBroadcast = DCNetwork_.inbox(epoch_).pop();
+
+                int senderIndex = members_->index(commitBroadcast.senderID());
+                uint32_t slot = (commitBroadcast.body().size() >= 2)
+                                ? (commitBroadcast.body()[0] << 8) | commitBroadcast.body()[1] : numSlots;
+                bool commitments = (commitBroadcast.msgType() == FinalRoundCommitments)
+                                   || (commitBroadcast.msgType() == FinalRoundCommitmentDigest);
+                if (commitments && ((senderIndex < 0) || (slot >= numSlots))) {
+                    // drop the commitments of nodes outside of the group and of unknown slots
+                    std::lock_guard<std::mutex> lock(threadMutex);
+                    remainingCommitments++;
+                    continue;
+                }
+                uint32_t memberIndex = senderIndex;
 
-                if (commitBroadcast.msgType() == FinalRoundCommitments) {
+                if ((commitBroadcast.msgType() == FinalRoundCommitments) && delayedVerification_) {
+                    // the commitments are not validated, therefore they are kept in their wire encoding
+                    std::lock_guard<std::mutex> lock(threadMutex);
+                    rawCommitments_[memberIndex][slot] = std::move(commitBroadcast.body());
+                } else if (commitBroadcast.msgType() == FinalRoundCommitments) {
                     std::vector<std::vector<CryptoPP::ECPPoint>> commitmentMatrix;
                     commitmentMatrix.reserve(k_);
-
-                    // decode the slot
-                    uint32_t slot = (commitBroadcast.body()[0] << 8) | (commitBroadcast.body()[1]);
-                    size_t numSlices = S[slot].size();
+                    size_t numCommitments = R[slot].size();
 
                     uint32_t offset = 2;
                     for (uint32_t share = 0; share < k_; share++) {
                         std::vector<CryptoPP::ECPPoint> commitmentVector;
-                        commitmentVector.reserve(numSlices);
+                        commitmentVector.reserve(numCommitments);
 
-                        for (uint32_t slice = 0; slice < numSlices; slice++, offset += encodedPointSize) {
+                        for (uint32_t slice = 0; slice < numCommitments; slice++, offset += encodedPointSize) {
                             CryptoPP::ECPPoint commitment;
                             threadCurve.GetCurve().DecodePoint(commitment, &commitBroadcast.body()[offset],
                                                                encodedPointSize);
@@ -420,9 +692,13 @@ void SecuredFinalRound::sharingPartOne() {
                         commitmentMatrix.push_back(std::move(commitmentVector));
                     }
                     std::lock_guard<std::mutex> lock(threadMutex);
-                    commitments_[commitBroadcast.senderID()][slot] = std::move(commitmentMatrix);
+                    commitments_[memberIndex][slot] = std::move(commitmentMatrix);
+                } else if (commitBroadcast.msgType() == FinalRoundCommitmentDigest) {
+                    std::lock_guard<std::mutex> lock(threadMutex);
+                    std::copy(&commitBroadcast.body()[2], &commitBroadcast.body()[2] + 32,
+                              commitmentDigests_[memberIndex][slot].begin());
                 } else {
-                    DCNetwork_.inbox().push(commitBroadcast);
+                    DCNetwork_.inbox(epoch_).push(commitBroadcast);
                     std::this_thread::sleep_for(std::chrono::milliseconds(1));
 
                     std::lock_guard<std::mutex> lock(threadMutex);
@@ -451,26 +727,34 @@ void SecuredFinalRound::sharingPartOne() {
                         break;
                     }
                 }
-                auto position = DCNetwork_.members().find(DCNetwork_.nodeID());
-                for (uint32_t member = 0; member < k_ - 1; member++) {
-                    position++;
-                    if (position == DCNetwork_.members().end())
-                        position = DCNetwork_.members().begin();
-
-                    uint32_t memberIndex = std::distance(DCNetwork_.members().begin(), position);
+                for (uint32_t member = 1; member < k_; member++) {
+                    uint32_t memberIndex = (nodeIndex_ + member) % k_;
                     size_t numSlices = S[slot].size();
-                    std::vector<uint8_t> sharingMessage(2 + 64 * numSlices);
+                    std::vector<uint8_t> sharingMessage;
+                    if (DCNetwork_.seededShares()) {
+                        // the seed suffices to expand the share and the blinding factors
+                        std::array<uint8_t, 32> seed = SeededShares::shareSeed(seeds_[slot], memberIndex);
+                        sharingMessage.resize(2 + 32);
+                        std::copy(seed.begin(), seed.end(), &sharingMessage[2]);
+                    } else if (DCNetwork_.vectorCommitments()) {
+                        // the single blinding factor followed by the slices
+                        sharingMessage.resize(2 + 32 + 32 * numSlices);
+                        rValues_[slot][memberIndex][0].Encode(&sharingMessage[2], 32);
+                        for (uint32_t slice = 0, offset = 34; slice < numSlices; slice++, offset += 32)
+                            shares_[slot][memberIndex][slice].Encode(&sharingMessage[offset], 32);
+                    } else {
+                        sharingMessage.resize(2 + 64 * numSlices);
+                        for (uint32_t slice = 0, offset = 2; slice < numSlices; slice++, offset += 64) {
+                            rValues_[slot][memberIndex][slice].Encode(&sharingMessage[offset], 32);
+                            shares_[slot][memberIndex][slice].Encode(&sharingMessage[offset + 32], 32);
+                        }
+                    }
                     sharingMessage[0] = (slot & 0xFF00) >> 8;
                     sharingMessage[1] = (slot & 0x00FF);
 
-                    for (uint32_t slice = 0, offset = 2; slice < numSlices; slice++, offset += 64) {
-                        rValues_[slot][memberIndex][slice].Encode(&sharingMessage[offset], 32);
-                        shares_[slot][memberIndex][slice].Encode(&sharingMessage[offset + 32], 32);
-                    }
-
-                    OutgoingMessage rsMessage(position->second.connectionID(), FinalRoundFirstSharing, DCNetwork_.nodeID(),
+                    OutgoingMessage rsMessage(members_->connectionID(memberIndex), FinalRoundFirstSharing, DCNetwork_.nodeID(),
                                               sharingMessage);
-                    DCNetwork_.outbox().push(std::move(rsMessage));
+                    DCNetwork_.send(std::move(rsMessage), epoch_);
                 }
             }
         });
@@ -483,27 +767,22 @@ void SecuredFinalRound::sharingPartOne() {
 
 int SecuredFinalRound::sharingPartTwo() {
     size_t numSlots = slots_.size();
-    if(delayedVerification_) {
-        rs_.reserve(k_-1);
-        for (auto member = DCNetwork_.members().begin(); member != DCNetwork_.members().end(); member++) {
-            if (member->first != DCNetwork_.nodeID()) {
-                std::vector<std::vector<std::pair<CryptoPP::Integer, CryptoPP::Integer>>> rsMatrix(numSlots);
-                for(uint32_t slot = 0; slot < numSlots; slot++)
-                    rsMatrix[slot].reserve(S[slot].size());
-                rs_.insert(std::pair(member->second.nodeID(), std::move(rsMatrix)));
-            }
-        }
-    }
+    if(delayedVerification_)
+        rs_.assign(k_, std::vector<std::vector<uint8_t>>(numSlots));
 
     // collect the shares from the other k-1 members and validate them using the broadcasted commitments
     std::list<std::future<int>> futures_;
     std::mutex threadMutex;
     uint32_t remainingShares = numSlots * (k_ - 1);
     uint32_t numThreads = DCNetwork_.numThreads() > numSlots ? numSlots : DCNetwork_.numThreads();
+
+    // without the validation of the commitments only a random fraction of the slices is verified
+    double auditRate = delayedVerification_ ? DCNetwork_.auditRate() : 0;
     for (uint32_t t = 0; t < numThreads; t++) {
         std::future<int> future = std::async(std::launch::async, [&]() {
             CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP> threadCurve;
             threadCurve.Initialize(CryptoPP::ASN1::secp256k1());
+            CryptoPP::AutoSeededRandomPool threadPRNG;
 
             for (;;) {
                 {
@@ -513,42 +792,109 @@ int SecuredFinalRound::sharingPartTwo() {
                     else
                         break;
                 }
-                auto sharingMessage = DCNetwork_.inbox().pop();
-
-                if (sharingMessage.msgType() == FinalRoundFirstSharing) {
+                auto sharingMessage = DCNetwork_.inbox(epoch_).pop();
 
+                int senderIndex = members_->index(sharingMessage.senderID());
+                if ((sharingMessage.msgType() == FinalRoundFirstSharing) && (senderIndex < 0)) {
+                    // drop the shares of nodes outside of the group
+                    std::lock_guard<std::mutex> lock(threadMutex);
+                    remainingShares++;
+                } else if (sharingMessage.msgType() == FinalRoundFirstSharing) {
+                    uint32_t memberIndex = senderIndex;
                     uint32_t slot = (sharingMessage.body()[0] << 8) | sharingMessage.body()[1];
                     size_t numSlices = S[slot].size();
-                    for (uint32_t slice = 0, offset = 2; slice < numSlices; slice++, offset += 64) {
-                        CryptoPP::Integer r(&sharingMessage.body()[offset], 32);
-                        CryptoPP::Integer s(&sharingMessage.body()[offset + 32], 32);
-
-                        if(delayedVerification_) {
-                            rs_[sharingMessage.senderID()][slot].push_back(std::pair(r,s));
-                        } else {
-                            // verify that the corresponding commitment is valid
-                            CryptoPP::ECPPoint rG = threadCurve.GetCurve().ScalarMultiply(G, r);
-                            CryptoPP::ECPPoint sH = threadCurve.GetCurve().ScalarMultiply(H, s);
-                            CryptoPP::ECPPoint commitment = threadCurve.GetCurve().Add(rG, sH);
-
-                            // if the commitment is invalid, blame the sender
-                            if ((commitment.x !=
-                                 commitments_[sharingMessage.senderID()][slot][DCNetwork_.nodeID()][slice].x)
-                                || (commitment.y !=
-                                    commitments_[sharingMessage.senderID()][slot][DCNetwork_.nodeID()][slice].y)) {
-
-                                SecuredFinalRound::injectBlameMessage(sharingMessage.senderID(), slot, slice, r, s);
+                    bool vectorCommitment = DCNetwork_.vectorCommitments();
+
+                    std::vector<CryptoPP::Integer> rValues;
+                    std::vector<CryptoPP::Integer> slices;
+                    if (DCNetwork_.seededShares()) {
+                        std::array<uint8_t, 32> seed;
+                        std::copy(&sharingMessage.body()[2], &sharingMessage.body()[2] + 32, seed.begin());
+                        SeededShares::expand(seed, numSlices, threadCurve.GetMaxExponent(), rValues, &slices);
+                        rValues.resize(R[slot].size());
+                    } else if (vectorCommitment) {
+                        rValues.push_back(CryptoPP::Integer(&sharingMessage.body()[2], 32));
+                        slices.reserve(numSlices);
+                        for (uint32_t slice = 0, offset = 34; slice < numSlices; slice++, offset += 32)
+                            slices.push_back(CryptoPP::Integer(&sharingMessage.body()[offset], 32));
+                    } else {
+                        rValues.reserve(numSlices);
+                        slices.reserve(numSlices);
+                        for (uint32_t slice = 0, offset = 2; slice < numSlices; slice++, offset += 64) {
+                            rValues.push_back(CryptoPP::Integer(&sharingMessage.body()[offset], 32));
+                            slices.push_back(CryptoPP::Integer(&sharingMessage.body()[offset + 32], 32));
+                        }
+                    }
+
+                    if (auditRate > 0) {
+                        uint32_t senderID = sharingMessage.senderID();
+                        int numAudited = SecuredFinalRound::auditShare(senderID, slot, rValues, slices, auditRate,
+                                [&](uint32_t slice) {
+                                    return SecuredFinalRound::receivedCommitment(memberIndex, slot, nodeIndex_, slice,
+                                                                                 threadCurve);
+                                }, threadCurve, threadPRNG);
+
+                        std::lock_guard<std::mutex> lock(threadMutex);
+                        if (numAudited < 0) {
+                            remainingShares = 0;
+                            return -1;
+                        }
+                        auditedSlices_ += numAudited;
+                    }
+
+                    // verify the share on the verification workers while the sharing proceeds
+                    if (verifier_) {
+                        uint32_t senderID = sharingMessage.senderID();
+                        verifier_->submit([this, senderID, memberIndex, slot, vectorCommitment, rValues, slices](
+                                CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& verifierCurve) mutable {
+                            if (vectorCommitment)
+                                return SecuredFinalRound::verifyShare(senderID, slot, rValues[0], slices,
+                                        commitments_[memberIndex][slot][nodeIndex_][0], verifierCurve);
+
+                            for (uint32_t slice = 0; slice < slices.size(); slice++) {
+                                if (!SecuredFinalRound::verifySlice(senderID, slot, slice, rValues[slice], slices[slice],
+                                        commitments_[memberIndex][slot][nodeIndex_][slice], verifierCurve))
+                                    return false;
+                            }
+                            return true;
+                        });
+                    }
+
+                    // a vector commitment is verified once for the whole share
+                    if (vectorCommitment && !delayedVerification_ && !verifier_) {
+                        if (!SecuredFinalRound::verifyShare(sharingMessage.senderID(), slot, rValues[0], slices,
+                                commitments_[memberIndex][slot][nodeIndex_][0], threadCurve)) {
+                            std::lock_guard<std::mutex> lock(threadMutex);
+                            remainingShares = 0;
+                            return -1;
+                        }
+                    }
+
+                    for (uint32_t slice = 0; slice < numSlices; slice++) {
+                        CryptoPP::Integer& r = rValues[vectorCommitment ? 0 : slice];
+                        CryptoPP::Integer& s = slices[slice];
+
+                        if (!delayedVerification_ && !vectorCommitment && !verifier_) {
+                            // verify that the corresponding commitment is valid, otherwise blame the sender
+                            if (!SecuredFinalRound::verifySlice(sharingMessage.senderID(), slot, slice, r, s,
+                                    commitments_[memberIndex][slot][nodeIndex_][slice], threadCurve)) {
                                 std::lock_guard<std::mutex> lock(threadMutex);
                                 remainingShares = 0;
                                 return -1;
                             }
                         }
                         std::lock_guard<std::mutex> lock(threadMutex);
-                        R[slot][slice] += r;
+                        if (!vectorCommitment || (slice == 0))
+                            R[slot][slice] += r;
                         S[slot][slice] += s;
                     }
+
+                    if(delayedVerification_) {
+                        std::lock_guard<std::mutex> lock(threadMutex);
+                        rs_[memberIndex][slot] = std::move(sharingMessage.body());
+                    }
                 } else {
-                    DCNetwork_.inbox().push(sharingMessage);
+                    DCNetwork_.inbox(epoch_).push(sharingMessage);
                     std::this_thread::sleep_for(std::chrono::milliseconds(1));
 
                     std::lock_guard<std::mutex> lock(threadMutex);
@@ -565,6 +911,10 @@ int SecuredFinalRound::sharingPartTwo() {
         if (f.get() < 0)
             return -1;
 
+    // the second sharing is broadcasted speculatively, unless an invalid share has already been detected
+    if (verifier_ && verifier_->failed())
+        return -1;
+
     // construct the sharing broadcast which includes the added shares
     uint32_t currentSlot = 0;
     std::list<std::thread> threads_;
@@ -586,28 +936,38 @@ int SecuredFinalRound::sharingPartTwo() {
                     }
                 }
                 size_t numSlices = S[slot].size();
-                std::vector<uint8_t> broadcastSlot(2 + 64 * numSlices);
-                broadcastSlot[0] = (slot & 0xFF00) >> 8;
-                broadcastSlot[1] = (slot & 0x00FF);
+                std::vector<uint8_t> broadcastSlot;
+                if (DCNetwork_.vectorCommitments()) {
+                    // the sum of the blinding factors followed by the added slices
+                    broadcastSlot.resize(2 + 32 + 32 * numSlices);
+                    R[slot][0] = R[slot][0].Modulo(threadCurve.GetGroupOrder());
+                    R[slot][0].Encode(&broadcastSlot[2], 32);
+
+                    for (uint32_t slice = 0, offset = 34; slice < numSlices; slice++, offset += 32) {
+                        S[slot][slice] = S[slot][slice].Modulo(threadCurve.GetGroupOrder());
+                        S[slot][slice].Encode(&broadcastSlot[offset], 32);
+                    }
+                } else {
+                    broadcastSlot.resize(2 + 64 * numSlices);
 
-                for (uint32_t slice = 0, offset = 2; slice < numSlices; slice++, offset += 64) {
-                    S[slot][slice] = S[slot][slice].Modulo(threadCurve.GetGroupOrder());
-                    R[slot][slice] = R[slot][slice].Modulo(threadCurve.GetGroupOrder());
+                    for (uint32_t slice = 0, offset = 2; slice < numSlices; slice++, offset += 64) {
+                        S[slot][slice] = S[slot][slice].Modulo(threadCurve.GetGroupOrder());
+                        R[slot][slice] = R[slot][slice].Modulo(threadCurve.GetGroupOrder());
 
-                    R[slot][slice].Encode(&broadcastSlot[offset], 32);
-                    S[slot][slice].Encode(&broadcastSlot[offset] + 32, 32);
+                        R[slot][slice].Encode(&broadcastSlot[offset], 32);
+                        S[slot][slice].Encode(&broadcastSlot[offset] + 32, 32);
+                    }
                 }
+                broadcastSlot[0] = (slot & 0xFF00) >> 8;
+                broadcastSlot[1] = (slot & 0x00FF);
 
-                auto position = DCNetwork_.members().find(DCNetwork_.nodeID());
-                for (uint32_t member = 0; member < k_ - 1; member++) {
-                    position++;
-                    if (position == DCNetwork_.members().end())
-                        position = DCNetwork_.members().begin();
+                for (uint32_t member = 1; member < k_; member++) {
+                    uint32_t memberIndex = (nodeIndex_ + member) % k_;
 
-                    OutgoingMessage rsBroadcast(position->second.connectionID(), FinalRoundSecondSharing,
+                    OutgoingMessage rsBroadcast(members_->connectionID(memberIndex), FinalRoundSecondSharing,
                                                 DCNetwork_.nodeID(),
                                                 broadcastSlot);
-                    DCNetwork_.outbox().push(std::move(rsBroadcast));
+                    DCNetwork_.send(std::move(rsBroadcast), epoch_);
                 }
             }
         });
@@ -620,26 +980,46 @@ int SecuredFinalRound::sharingPartTwo() {
 
 std::vector<std::vector<uint8_t>> SecuredFinalRound::resultComputation() {
     size_t numSlots = S.size();
-    if(delayedVerification_) {
-        RS_.reserve(k_-1);
-        for (auto member = DCNetwork_.members().begin(); member != DCNetwork_.members().end(); member++) {
-            if (member->first != DCNetwork_.nodeID()) {
-                std::vector<std::vector<std::pair<CryptoPP::Integer, CryptoPP::Integer>>> rsMatrix(numSlots);
-                for(uint32_t slot = 0; slot < numSlots; slot++)
-                    rsMatrix[slot].reserve(S[slot].size());
-                RS_.insert(std::pair(member->second.nodeID(), std::move(rsMatrix)));
-            }
-        }
-    }
+    if(delayedVerification_)
+        RS_.assign(k_, std::vector<std::vector<uint8_t>>(numSlots));
 
     std::list<std::future<int>> futures_;
     std::mutex threadMutex;
     uint32_t remainingShares = numSlots * (k_ - 1);
+
+    // a slot is delivered as soon as the added shares of all other members have been received and verified
+    // and its CRC is valid. Without the immediate verification of every share the slots are held back
+    // until the end of the round, the payloads of the hybrid mode are only known after this round.
+    // In the delayed verification mode a disruption is only detected once all slots have been reconstructed,
+    // a streamed slot could carry the output of a member, who is convicted afterwards.
+    std::vector<uint32_t> remainingSlotShares(numSlots, k_ - 1);
+    if (!hybrid_ && !delayedVerification_ && !verifier_)
+        deliveredSlots_.assign(numSlots, 0);
     uint32_t numThreads = DCNetwork_.numThreads() > numSlots ? numSlots : DCNetwork_.numThreads();
+
+    // without the validation of the commitments only a random fraction of the slices is verified
+    double auditRate = delayedVerification_ ? DCNetwork_.auditRate() : 0;
     for (uint32_t t = 0; t < numThreads; t++) {
         std::future<int> future = std::async(std::launch::async, [&]() {
             CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP> threadCurve;
             threadCurve.Initialize(CryptoPP::ASN1::secp256k1());
+            CryptoPP::AutoSeededRandomPool threadPRNG;
+            CryptoPP::CRC32 threadCRC;
+
+            // delivers the slot if the share was the last one missing
+            auto completeShare = [&](uint32_t slot) {
+                {
+                    std::lock_guard<std::mutex> lock(threadMutex);
+                    if ((--remainingSlotShares[slot] > 0) || deliveredSlots_.empty())
+                        return;
+                }
+                std::vector<uint8_t> messageSlot = SecuredFinalRound::reconstructSlot(slot);
+                threadCRC.Update(&messageSlot[4], messageSlot.size() - 4);
+                if (threadCRC.Verify(messageSlot.data())) {
+                    SecuredFinalRound::deliverSlot(slot, messageSlot);
+                    deliveredSlots_[slot] = 1;
+                }
+            };
 
             for (;;) {
                 {
@@ -649,52 +1029,87 @@ std::vector<std::vector<uint8_t>> SecuredFinalRound::resultComputation() {
                     else
                         return 0;
                 }
-                auto rsBroadcast = DCNetwork_.inbox().pop();
+                auto rsBroadcast = DCNetwork_.inbox(epoch_).pop();
 
                 if (rsBroadcast.msgType() == FinalRoundSecondSharing) {
-                    uint32_t memberIndex = std::distance(DCNetwork_.members().begin(),
-                                                         DCNetwork_.members().find(rsBroadcast.senderID()));
+                    int senderIndex = members_->index(rsBroadcast.senderID());
+                    if (senderIndex < 0) {
+                        // drop the shares of nodes outside of the group
+                        std::lock_guard<std::mutex> lock(threadMutex);
+                        remainingShares++;
+                        continue;
+                    }
+                    uint32_t memberIndex = senderIndex;
 
+                    uint32_t senderID = rsBroadcast.senderID();
                     uint32_t slot = (rsBroadcast.body()[0] << 8) | rsBroadcast.body()[1];
                     size_t numSlices = S[slot].size();
-                    for (uint32_t slice = 0, offset = 2; slice < numSlices; slice++, offset += 64) {
-                        // extract and decode the random values and the slice of the share
-                        CryptoPP::Integer R_(&rsBroadcast.body()[offset], 32);
-                        CryptoPP::Integer S_(&rsBroadcast.body()[offset + 32], 32);
-
-                        if(delayedVerification_) {
-                            RS_[rsBroadcast.senderID()][slot].push_back(std::pair(R_,S_));
-                        } else {
-                            // validate r and s
-                            CryptoPP::ECPPoint addedCommitments;
-                            for (auto &c : commitments_)
-                                addedCommitments = threadCurve.GetCurve().Add(addedCommitments,
-                                                                              c.second[slot][memberIndex][slice]);
-
-                            CryptoPP::ECPPoint rG = threadCurve.GetCurve().ScalarMultiply(G, R_);
-                            CryptoPP::ECPPoint sH = threadCurve.GetCurve().ScalarMultiply(H, S_);
-                            CryptoPP::ECPPoint commitment = threadCurve.GetCurve().Add(rG, sH);
-
-                            if ((commitment.x != addedCommitments.x) || (commitment.y != addedCommitments.y)) {
-                                // broadcast a blame message which contains the invalid share along with the corresponding r values
-                                std::cout << "Invalid commitment detected" << std::endl;
-                                SecuredFinalRound::injectBlameMessage(rsBroadcast.senderID(), slot, slice, R_, S_);
-                                std::lock_guard<std::mutex> lock(threadMutex);
-                                remainingShares = 0;
-                                return -1;
-                            }
+                    bool vectorCommitment = DCNetwork_.vectorCommitments();
+
+                    // extract and decode the random values and the slices of the added shares
+                    std::vector<CryptoPP::Integer> rValues;
+                    std::vector<CryptoPP::Integer> slices;
+                    slices.reserve(numSlices);
+                    if (vectorCommitment) {
+                        rValues.push_back(CryptoPP::Integer(&rsBroadcast.body()[2], 32));
+                        for (uint32_t slice = 0, offset = 34; slice < numSlices; slice++, offset += 32)
+                            slices.push_back(CryptoPP::Integer(&rsBroadcast.body()[offset], 32));
+                    } else {
+                        rValues.reserve(numSlices);
+                        for (uint32_t slice = 0, offset = 2; slice < numSlices; slice++, offset += 64) {
+                            rValues.push_back(CryptoPP::Integer(&rsBroadcast.body()[offset], 32));
+                            slices.push_back(CryptoPP::Integer(&rsBroadcast.body()[offset + 32], 32));
                         }
+                    }
+
+                    // the added shares have to match the sum of the commitments of all members
+                    if (verifier_) {
+                        verifier_->submit([this, senderID, memberIndex, slot, rValues, slices](
+                                CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& verifierCurve) {
+                            return SecuredFinalRound::verifyAddedShares(senderID, memberIndex, slot, rValues, slices,
+                                                                        verifierCurve);
+                        });
+                    }
+
+                    if (auditRate > 0) {
+                        int numAudited = SecuredFinalRound::auditShare(senderID, slot, rValues, slices, auditRate,
+                                [&](uint32_t slice) {
+                                    return SecuredFinalRound::addedCommitment(slot, memberIndex, slice, threadCurve);
+                                }, threadCurve, threadPRNG);
+
                         std::lock_guard<std::mutex> lock(threadMutex);
-                        R[slot][slice] += R_;
-                        S[slot][slice] += S_;
+                        if (numAudited < 0) {
+                            remainingShares = 0;
+                            return -1;
+                        }
+                        auditedSlices_ += numAudited;
                     }
 
+                    if (!delayedVerification_ && !verifier_ &&
+                        !SecuredFinalRound::verifyAddedShares(senderID, memberIndex, slot, rValues, slices,
+                                                              threadCurve)) {
+                        std::lock_guard<std::mutex> lock(threadMutex);
+                        remainingShares = 0;
+                        return -1;
+                    }
+
+                    {
+                        std::lock_guard<std::mutex> lock(threadMutex);
+                        for (uint32_t i = 0; i < rValues.size(); i++)
+                            R[slot][i] += rValues[i];
+                        for (uint32_t slice = 0; slice < numSlices; slice++)
+                            S[slot][slice] += slices[slice];
+
+                        if (delayedVerification_)
+                            RS_[memberIndex][slot] = std::move(rsBroadcast.body());
+                    }
+                    completeShare(slot);
                 } else if (rsBroadcast.msgType() == InvalidShare) {
                     SecuredFinalRound::handleBlameMessage(rsBroadcast);
                     std::cout << "Blame message received" << std::endl;
                     return -1;
                 } else {
-                    DCNetwork_.inbox().push(rsBroadcast);
+                    DCNetwork_.inbox(epoch_).push(rsBroadcast);
                     std::this_thread::sleep_for(std::chrono::milliseconds(1));
                     std::lock_guard<std::mutex> lock(threadMutex);
                     remainingShares++;
@@ -710,22 +1125,23 @@ std::vector<std::vector<uint8_t>> SecuredFinalRound::resultComputation() {
         if (f.get() < 0)
             return std::vector<std::vector<uint8_t>>();
 
+    // the round is finished only after all received shares have been verified
+    if (verifier_ && !verifier_->wait())
+        return std::vector<std::vector<uint8_t>>();
+
     // notify the other nodes that the execution was successful
-    auto position = DCNetwork_.members().find(DCNetwork_.nodeID());
-    for (uint32_t member = 0; member < k_ - 1; member++) {
-        position++;
-        if (position == DCNetwork_.members().end())
-            position = DCNetwork_.members().begin();
+    for (uint32_t member = 1; member < k_; member++) {
+        uint32_t memberIndex = (nodeIndex_ + member) % k_;
 
-        OutgoingMessage finishedBroadcast(position->second.connectionID(), FinalRoundFinished,
+        OutgoingMessage finishedBroadcast(members_->connectionID(memberIndex), FinalRoundFinished,
                                           DCNetwork_.nodeID());
-        DCNetwork_.outbox().push(std::move(finishedBroadcast));
+        DCNetwork_.send(std::move(finishedBroadcast), epoch_);
     }
 
     // wait for the remaining nodes to finish the second sharing phase and catch potential blame messages
     uint32_t remainingNodes = k_-1;
     while(remainingNodes > 0) {
-        auto message = DCNetwork_.inbox().pop();
+        auto message = DCNetwork_.inbox(epoch_).pop();
         if(message.msgType() == FinalRoundFinished) {
             remainingNodes--;
         } else if(message.msgType() == InvalidShare){
@@ -733,102 +1149,390 @@ std::vector<std::vector<uint8_t>> SecuredFinalRound::resultComputation() {
             std::cout << "Blame message received" << std::endl;
             return std::vector<std::vector<uint8_t>>();
         } else {
-            DCNetwork_.inbox().push(message);
+            DCNetwork_.inbox(epoch_).push(message);
             std::this_thread::sleep_for(std::chrono::milliseconds(5));
         }
     }
 
     // reconstruct the original message
     std::vector<std::vector<uint8_t>> reconstructedMessageSlots(numSlots);
-    for (uint32_t slot = 0; slot < numSlots; slot++) {
-        reconstructedMessageSlots[slot].resize(4 + slots_[slot].first);
+    for (uint32_t slot = 0; slot < numSlots; slot++)
+        reconstructedMessageSlots[slot] = SecuredFinalRound::reconstructSlot(slot);
 
-        for (uint32_t slice = 0; slice < S[slot].size(); slice++) {
-            size_t sliceSize = ((4 + slots_[slot].first - 31 * slice > 31) ? 31 : 4 + slots_[slot].first - 31 * slice);
-            S[slot][slice] = S[slot][slice].Modulo(curve.GetGroupOrder());
-            S[slot][slice].Encode(&reconstructedMessageSlots[slot][31 * slice], sliceSize);
+    return reconstructedMessageSlots;
+}
+
+std::vector<uint8_t> SecuredFinalRound::reconstructSlot(uint32_t slot) {
+    std::vector<uint8_t> messageSlot(4 + slots_[slot].first);
+
+    for (uint32_t slice = 0; slice < S[slot].size(); slice++) {
+        size_t sliceSize = ((4 + slots_[slot].first - 31 * slice > 31) ? 31 : 4 + slots_[slot].first - 31 * slice);
+        S[slot][slice] = S[slot][slice].Modulo(curve.GetGroupOrder());
+        S[slot][slice].Encode(&messageSlot[31 * slice], sliceSize);
+    }
+    return messageSlot;
+}
+
+void SecuredFinalRound::deliverSlot(uint32_t slot, const std::vector<uint8_t>& messageSlot) {
+    // skip the lease header
+    size_t offset = std::min(4 + leaseSize_, messageSlot.size());
+    std::vector<uint8_t> message(messageSlot.begin() + offset, messageSlot.end());
+
+    {
+        std::lock_guard<std::mutex> lock(loggingMutex);
+        std::string msgHash = utils::sha256(message);
+        std::cout << "Node " << std::dec << DCNetwork_.nodeID() << " received message in slot " << slot << ": |";
+        for (uint8_t c : msgHash) {
+            std::cout << std::hex << std::setw(2) << std::setfill('0') << (int) c;
         }
+        std::cout << "|" << std::dec << std::endl;
     }
-    return reconstructedMessageSlots;
+
+    // check if a VS Token has to be generated for this message by this node
+    if(DCNetwork_.AD() && (slots_[slot].second >= nodeIndex_*65535/k_) && (slots_[slot].second < (nodeIndex_+1)*65535/k_)) {
+        std::lock_guard<std::mutex> lock(loggingMutex);
+        std::cout << "Node " << nodeIndex_ << "Generating VS Token for slot " << slot << std::endl;
+        std::vector<uint8_t> VSToken = VirtualSource::generateVSToken(0, 0, message);
+        OutgoingMessage vsForward(SELF, VirtualSourceToken, DCNetwork_.nodeID(), VSToken);
+        DCNetwork_.outbox().push(vsForward);
+    }
+
+    // pass the final message through the message handler to store it in the message buffer
+    OutgoingMessage finalMessage(SELF, DCNetworkReceived, SELF, std::move(message));
+    DCNetwork_.outbox().push(std::move(finalMessage));
 }
 
-void SecuredFinalRound::injectBlameMessage(uint32_t suspectID, uint32_t slot, uint32_t slice, CryptoPP::Integer &r,
-                                           CryptoPP::Integer &s) {
-    std::vector<uint8_t> messageBody(76);
-    // set the suspect's ID
-    messageBody[0] = (suspectID & 0xFF000000) >> 24;
-    messageBody[1] = (suspectID & 0x00FF0000) >> 16;
-    messageBody[2] = (suspectID & 0x0000FF00) >> 8;
-    messageBody[3] = (suspectID & 0x000000FF);
-
-    // set the index of the slot
-    messageBody[4] = (slot & 0xFF000000) >> 24;
-    messageBody[5] = (slot & 0x00FF0000) >> 16;
-    messageBody[6] = (slot & 0x0000FF00) >> 8;
-    messageBody[7] = (slot & 0x000000FF);
-
-    // set the index of the slice
-    messageBody[6] = (slice & 0xFF000000) >> 24;
-    messageBody[9] = (slice & 0x00FF0000) >> 16;
-    messageBody[10] = (slice & 0x0000FF00) >> 8;
-    messageBody[11] = (slice & 0x000000FF);
-
-    // store the corrupt share
-    r.Encode(&messageBody[12], 32);
-    s.Encode(&messageBody[44], 32);
-
-    for (auto &member : DCNetwork_.members()) {
-        if (member.second.connectionID() != SELF) {
-            OutgoingMessage blameMessage(member.second.connectionID(), InvalidShare, DCNetwork_.nodeID(), messageBody);
-            DCNetwork_.outbox().push(blameMessage);
+int SecuredFinalRound::revealCommitments() {
+    size_t numSlots = slots_.size();
+
+    // broadcast the encoded commitments, which have been announced by their digests
+    for (uint32_t member = 1; member < k_; member++) {
+        uint32_t memberIndex = (nodeIndex_ + member) % k_;
+
+        for (uint32_t slot = 0; slot < numSlots; slot++) {
+            OutgoingMessage commitBroadcast(members_->connectionID(memberIndex), FinalRoundCommitments,
+                                            DCNetwork_.nodeID(), encodedCommitments_[slot]);
+            DCNetwork_.send(std::move(commitBroadcast), epoch_);
+        }
+    }
+
+    uint32_t remainingCommitments = numSlots * (k_ - 1);
+    while (remainingCommitments > 0) {
+        auto commitBroadcast = DCNetwork_.inbox(epoch_).pop();
+
+        if (commitBroadcast.msgType() == FinalRoundCommitments) {
+            int senderIndex = members_->index(commitBroadcast.senderID());
+            uint32_t slot = (commitBroadcast.body().size() >= 2)
+                            ? (commitBroadcast.body()[0] << 8) | commitBroadcast.body()[1] : numSlots;
+            // drop the commitments of nodes outside of the group and of unknown slots
+            if ((senderIndex < 0) || (slot >= numSlots))
+                continue;
+            uint32_t memberIndex = senderIndex;
+
+            // the revealed commitments have to match the announced digest
+            std::array<uint8_t, 32> digest = utils::sha256Digest(commitBroadcast.body());
+            if (digest != commitmentDigests_[memberIndex][slot]) {
+                std::cout << "Revealed commitments do not match the digest" << std::endl;
+                if (DCNetwork_.securityLevel() == Adaptive)
+                    DCNetwork_.adaptiveSecurity().escalate(AdaptiveValidated, "revealed commitments do not match");
+                DCNetwork_.excludeMember(commitBroadcast.senderID());
+                return -1;
+            }
+
+            // the commitments are decoded only if they are required
+            rawCommitments_[memberIndex][slot] = std::move(commitBroadcast.body());
+            remainingCommitments--;
+        } else {
+            DCNetwork_.inbox(epoch_).push(commitBroadcast);
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
         }
     }
+    return 0;
 }
 
+void SecuredFinalRound::decodeCommitments() {
+    size_t encodedPointSize = curve.GetCurve().EncodedPointSize(true);
 
-void SecuredFinalRound::handleBlameMessage(ReceivedMessage &blameMessage) {
-    std::vector<uint8_t> &body = blameMessage.body();
-    // check which node is addressed by the blame message
-    uint32_t suspectID = (body[0] << 24) | (body[1] << 16) | (body[2] << 8) | body[3];
+    // collect the encoded commitment matrices
+    std::vector<std::pair<uint32_t, uint32_t>> encodings;
+    for (uint32_t memberIndex = 0; memberIndex < rawCommitments_.size(); memberIndex++)
+        for (uint32_t slot = 0; slot < rawCommitments_[memberIndex].size(); slot++)
+            if (rawCommitments_[memberIndex][slot].size() > 0)
+                encodings.push_back(std::pair(memberIndex, slot));
+
+    std::mutex threadMutex;
+    std::list<std::thread> threads_;
+    uint32_t currentEncoding = 0;
+    for (uint32_t t = 0; t < DCNetwork_.numThreads(); t++) {
+        std::thread decodingThread([&]() {
+            CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP> threadCurve;
+            threadCurve.Initialize(CryptoPP::ASN1::secp256k1());
+
+            for (;;) {
+                uint32_t index;
+                {
+                    std::lock_guard<std::mutex> lock(threadMutex);
+                    if (currentEncoding < encodings.size()) {
+                        index = currentEncoding;
+                        currentEncoding++;
+                    } else {
+                        break;
+                    }
+                }
+                uint32_t memberIndex = encodings[index].first;
+                uint32_t slot = encodings[index].second;
+                size_t numCommitments = R[slot].size();
+                std::vector<uint8_t> &encoding = rawCommitments_[memberIndex][slot];
+
+                std::vector<std::vector<CryptoPP::ECPPoint>> commitmentMatrix(k_);
+                uint32_t offset = 2;
+                for (uint32_t share = 0; share < k_; share++) {
+                    commitmentMatrix[share].reserve(numCommitments);
+                    for (uint32_t slice = 0; slice < numCommitments; slice++, offset += encodedPointSize) {
+                        CryptoPP::ECPPoint commitment;
+                        threadCurve.GetCurve().DecodePoint(commitment, &encoding[offset], encodedPointSize);
 
-    // extract the index of the slot
-    uint32_t slot = (body[4] << 24) | (body[5] << 16) | (body[6] << 8) | body[7];
+                        commitmentMatrix[share].push_back(std::move(commitment));
+                    }
+                }
+                std::lock_guard<std::mutex> lock(threadMutex);
+                commitments_[memberIndex][slot] = std::move(commitmentMatrix);
+                encoding.clear();
+            }
+        });
+        threads_.push_back(std::move(decodingThread));
+    }
 
-    // extract the index of the corrupted slice
-    uint32_t slice = (body[8] << 24) | (body[9] << 16) | (body[10] << 8) | body[11];
+    for (auto &t : threads_)
+        t.join();
+}
 
-    // extract the the corrupted slice
-    CryptoPP::Integer r(&body[12], 32);
-    CryptoPP::Integer s(&body[44], 32);
+CryptoPP::ECPPoint SecuredFinalRound::receivedCommitment(uint32_t memberIndex, uint32_t slot, uint32_t share, uint32_t slice,
+                                                         CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve) {
+    if (commitments_[memberIndex][slot].size() > 0)
+        return commitments_[memberIndex][slot][share][slice];
 
-    // validate that the slice is actually corrupt
-    CryptoPP::ECPPoint rG = curve.GetCurve().ScalarMultiply(G, r);
-    CryptoPP::ECPPoint sH = curve.GetCurve().ScalarMultiply(H, s);
-    CryptoPP::ECPPoint commitment = curve.GetCurve().Add(rG, sH);
+    // decode only the requested commitment
+    size_t encodedPointSize = threadCurve.GetCurve().EncodedPointSize(true);
+    size_t offset = 2 + (share * R[slot].size() + slice) * encodedPointSize;
 
-    uint32_t memberIndex = std::distance(DCNetwork_.members().begin(),
-                                         DCNetwork_.members().find(suspectID));
+    CryptoPP::ECPPoint commitment;
+    if ((memberIndex < rawCommitments_.size())
+        && (rawCommitments_[memberIndex][slot].size() >= offset + encodedPointSize))
+        threadCurve.GetCurve().DecodePoint(commitment, &rawCommitments_[memberIndex][slot][offset], encodedPointSize);
 
-    // compare the commitment, generated using the submitted values, with the commitment
-    // which has been broadcasted by the suspect
-    if ((commitment.x != commitments_[suspectID][slot][memberIndex][slice].x)
-        || (commitment.y != commitments_[suspectID][slot][memberIndex][slice].y)) {
-        // if the two commitments do not match, the suspect is removed
-        DCNetwork_.members().erase(suspectID);
-    } else {
-        // if the two commitments match, the sender is removed
-        DCNetwork_.members().erase(blameMessage.senderID());
+    return commitment;
+}
+
+void SecuredFinalRound::payloadSharing() {
+    size_t numSlots = payloads_.size();
+
+    for (uint32_t member = 1; member < k_; member++) {
+        uint32_t memberIndex = (nodeIndex_ + member) % k_;
+
+        for (uint32_t slot = 0; slot < numSlots; slot++) {
+            std::vector<uint8_t> paddedSlot(2 + payloads_[slot].size());
+            paddedSlot[0] = (slot & 0xFF00) >> 8;
+            paddedSlot[1] = (slot & 0x00FF);
+            std::copy(payloads_[slot].begin(), payloads_[slot].end(), &paddedSlot[2]);
+            OutgoingMessage sharingMessage(members_->connectionID(memberIndex), HybridPayloadSharing, DCNetwork_.nodeID(),
+                                           paddedSlot);
+            DCNetwork_.send(std::move(sharingMessage), epoch_);
+        }
     }
 }
 
+void SecuredFinalRound::payloadComputation() {
+    size_t numSlots = payloads_.size();
+
+    uint32_t remainingShares = numSlots * (k_ - 1);
+    while (remainingShares > 0) {
+        auto sharingBroadcast = DCNetwork_.inbox(epoch_).pop();
+
+        if (sharingBroadcast.msgType() == HybridPayloadSharing) {
+            size_t slot = (sharingBroadcast.body()[0] << 8) | sharingBroadcast.body()[1];
+
+            for (uint32_t p = 0; p < payloads_[slot].size(); p++)
+                payloads_[slot][p] ^= sharingBroadcast.body()[p + 2];
+
+            remainingShares--;
+        } else {
+            DCNetwork_.inbox(epoch_).push(sharingBroadcast);
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+}
 
+bool SecuredFinalRound::agreeOnPayloads(bool matches) {
+    std::vector<uint8_t> verdict(1, matches ? 1 : 0);
+    for (uint32_t member = 1; member < k_; member++) {
+        uint32_t memberIndex = (nodeIndex_ + member) % k_;
 
+        OutgoingMessage verdictMessage(members_->connectionID(memberIndex), HybridPayloadVerdict, DCNetwork_.nodeID(),
+                                       verdict);
+        DCNetwork_.send(std::move(verdictMessage), epoch_);
+    }
 
+    std::set<uint32_t> remainingMembers;
+    for (uint32_t memberIndex = 0; memberIndex < k_; memberIndex++)
+        if (memberIndex != nodeIndex_)
+            remainingMembers.insert(members_->nodeID(memberIndex));
 
+    while (!remainingMembers.empty()) {
+        auto message = DCNetwork_.inbox(epoch_).pop();
+        if (message.msgType() != HybridPayloadVerdict) {
+            DCNetwork_.inbox(epoch_).push(message);
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            continue;
+        }
 
+        // each member is counted once
+        if (remainingMembers.erase(message.senderID()) == 0)
+            continue;
+        if (message.body().empty() || (message.body()[0] == 0))
+            matches = false;
+    }
+    return matches;
+}
 
+bool SecuredFinalRound::payloadMatches(uint32_t slot, const std::vector<uint8_t>& digestSlot) {
+    std::vector<uint8_t>& payloadSlot = payloads_[slot];
 
+    CRC32_.Update(&payloadSlot[4], payloadSlot.size() - 4);
+    if (!CRC32_.Verify(payloadSlot.data()))
+        return false;
 
+    // compare the length and the digest, the digest slot is prefixed by its CRC
+    uint16_t length = (digestSlot[4] << 8) | digestSlot[5];
+    if (length != payloadSlot.size() - 4)
+        return false;
 
+    std::vector<uint8_t> payload(payloadSlot.begin() + 4, payloadSlot.end());
+    std::array<uint8_t, 32> digest = utils::sha256Digest(payload);
+    return std::equal(digest.begin(), digest.end(), &digestSlot[6]);
+}
 
+bool SecuredFinalRound::verifySlice(uint32_t senderID, uint32_t slot, uint32_t slice, const CryptoPP::Integer& r,
+                                    const CryptoPP::Integer& s, const CryptoPP::ECPPoint& commitment,
+                                    CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve) {
+    if (SpotCheck::opens(threadCurve, commitment, r, s))
+        return true;
 
+    std::cout << "Invalid commitment detected" << std::endl;
+    SecuredFinalRound::injectBlameMessage(senderID, slot, slice, r, {s});
+    return false;
+}
+
+bool SecuredFinalRound::verifyShare(uint32_t senderID, uint32_t slot, const CryptoPP::Integer& r,
+                                    const std::vector<CryptoPP::Integer>& slices,
+                                    const CryptoPP::ECPPoint& commitment,
+                                    CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve) {
+    CryptoPP::ECPPoint opened = generators_->commit(threadCurve, r, slices);
+    if ((opened.x == commitment.x) && (opened.y == commitment.y))
+        return true;
+
+    std::cout << "Invalid commitment detected" << std::endl;
+    // the slice index is omitted, since the whole share is submitted
+    SecuredFinalRound::injectBlameMessage(senderID, slot, 0, r, slices);
+    return false;
+}
+
+bool SecuredFinalRound::verifyAddedShares(uint32_t senderID, uint32_t memberIndex, uint32_t slot,
+                                          const std::vector<CryptoPP::Integer>& rValues,
+                                          const std::vector<CryptoPP::Integer>& slices,
+                                          CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve) {
+    if (DCNetwork_.vectorCommitments())
+        return SecuredFinalRound::verifyShare(senderID, slot, rValues[0], slices,
+                SecuredFinalRound::addedCommitment(slot, memberIndex, 0, threadCurve), threadCurve);
+
+    for (uint32_t slice = 0; slice < slices.size(); slice++) {
+        if (!SecuredFinalRound::verifySlice(senderID, slot, slice, rValues[slice], slices[slice],
+                SecuredFinalRound::addedCommitment(slot, memberIndex, slice, threadCurve), threadCurve))
+            return false;
+    }
+    return true;
+}
+
+int SecuredFinalRound::auditShare(uint32_t senderID, uint32_t slot, const std::vector<CryptoPP::Integer>& rValues,
+                                  const std::vector<CryptoPP::Integer>& slices, double auditRate,
+                                  const std::function<CryptoPP::ECPPoint(uint32_t)>& commitment,
+                                  CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve,
+                                  CryptoPP::RandomNumberGenerator& threadPRNG) {
+    if (DCNetwork_.vectorCommitments()) {
+        // a vector commitment can only be audited as a whole
+        if (SpotCheck::sample(threadPRNG, 1, auditRate).size() == 0)
+            return 0;
+        if (!SecuredFinalRound::verifyShare(senderID, slot, rValues[0], slices, commitment(0), threadCurve))
+            return -1;
+        return slices.size();
+    }
+
+    size_t numAudited;
+    int invalid = SpotCheck::audit(threadCurve, threadPRNG, auditRate, rValues, slices, commitment, numAudited);
+    if (invalid > -1) {
+        std::cout << "Invalid commitment detected" << std::endl;
+        SecuredFinalRound::injectBlameMessage(senderID, slot, invalid, rValues[invalid], {slices[invalid]});
+        return -1;
+    }
+    return numAudited;
+}
+
+CryptoPP::ECPPoint SecuredFinalRound::addedCommitment(uint32_t slot, uint32_t share, uint32_t slice,
+                                                      CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve) {
+    CryptoPP::ECPPoint addedCommitments;
+    for (uint32_t memberIndex = 0; memberIndex < k_; memberIndex++)
+        addedCommitments = threadCurve.GetCurve().Add(addedCommitments,
+                SecuredFinalRound::receivedCommitment(memberIndex, slot, share, slice, threadCurve));
+    return addedCommitments;
+}
+
+void SecuredFinalRound::injectBlameMessage(uint32_t suspectID, uint32_t slot, uint32_t slice,
+                                           const CryptoPP::Integer& r, const std::vector<CryptoPP::Integer>& slices) {
+    BlameMessage::broadcast(DCNetwork_, epoch_, suspectID, BlameMessage::encode(suspectID, slot, slice, r, slices));
+}
+
+std::unique_ptr<DCState> SecuredFinalRound::abortRound() {
+    // the members which received different blame messages first would otherwise convict different members
+    if (DCNetwork_.fastRecovery())
+        BlameMessage::collect(DCNetwork_, epoch_, [this](ReceivedMessage& message) {
+            SecuredFinalRound::handleBlameMessage(message);
+        });
+    return InitState::recover(DCNetwork_, epoch_);
+}
+
+void SecuredFinalRound::handleBlameMessage(ReceivedMessage &blameMessage) {
+    if (DCNetwork_.securityLevel() == Adaptive)
+        DCNetwork_.adaptiveSecurity().escalate(AdaptiveValidated, "blame message received");
+
+    BlameMessage::Accusation accusation;
+    if (BlameMessage::decode(blameMessage.body(), accusation) < 0) {
+        std::cout << "Malformed blame message received" << std::endl;
+        return;
+    }
+
+    int suspectIndex = members_->index(accusation.suspectID);
+    if (suspectIndex < 0) {
+        std::cout << "Blame message for a non-member received" << std::endl;
+        return;
+    }
+    if ((accusation.slot >= R.size()) || (accusation.slice >= R[accusation.slot].size())) {
+        std::cout << "Blame message for a non-existent slice received" << std::endl;
+        return;
+    }
+
+    // validate that the disclosed share is actually corrupt, i.e. it does not open the commitment
+    // which has been broadcasted by the suspect
+    CryptoPP::ECPPoint suspectCommitment = SecuredFinalRound::receivedCommitment(suspectIndex, accusation.slot,
+                                                                                 suspectIndex, accusation.slice, curve);
+    CryptoPP::ECPPoint commitment = DCNetwork_.vectorCommitments()
+            ? generators_->commit(curve, accusation.r, accusation.slices)
+            : SpotCheck::commit(curve, accusation.r, accusation.slices[0]);
+
+    if ((commitment.x != suspectCommitment.x) || (commitment.y != suspectCommitment.y)) {
+        // if the two commitments do not match, the suspect is removed
+        DCNetwork_.excludeMember(accusation.suspectID);
+    } else {
+        // if the two commitments match, the sender is removed
+        DCNetwork_.excludeMember(blameMessage.senderID());
+    }
+}
@@ -1,7 +1,9 @@
 #ifndef THREEPP_SECUREDFINALROUND_H
 #define THREEPP_SECUREDFINALROUND_H
 
+#include <memory>
 #include <array>
+#include <functional>
 #include <vector>
 #include <cryptopp/osrng.h>
 #include <cryptopp/eccrypto.h>
@@ -10,12 +12,16 @@
 #include <unordered_map>
 #include <cryptopp/crc.h>
 #include "DCState.h"
+#include "MemberTable.h"
 #include "../datastruct/ReceivedMessage.h"
+#include "AsyncVerifier.h"
+#include "VectorCommitment.h"
 
 class SecuredFinalRound : public DCState {
 public:
-    SecuredFinalRound(DCNetwork& DCNet, int slotIndex, std::vector<std::pair<uint16_t, uint16_t>> slots,
-            std::vector<CryptoPP::Integer> seedPrivateKeys, std::vector<std::array<uint8_t, 32>> receivedSeeds);
+    SecuredFinalRound(DCNetwork& DCNet, std::vector<int> slotIndices, std::vector<std::pair<uint16_t, uint16_t>> slots,
+            std::vector<std::vector<CryptoPP::Integer>> seedPrivateKeys, std::vector<std::array<uint8_t, 32>> receivedSeeds,
+            uint64_t epoch, uint32_t leasedRounds = 0);
 
     virtual ~SecuredFinalRound();
 
@@ -30,43 +36,131 @@ private:
 
     std::vector<std::vector<uint8_t>> resultComputation();
 
-    void injectBlameMessage(uint32_t suspectID, uint32_t slot, uint32_t slice, CryptoPP::Integer& r, CryptoPP::Integer& s);
+    // encodes the sum of the shares of a slot
+    std::vector<uint8_t> reconstructSlot(uint32_t slot);
+
+    // passes the message of a slot to the message handler and generates the VS token if required
+    void deliverSlot(uint32_t slot, const std::vector<uint8_t>& messageSlot);
+
+    // verifies a slice against its commitment and blames the sender if it does not match
+    bool verifySlice(uint32_t senderID, uint32_t slot, uint32_t slice, const CryptoPP::Integer& r,
+                     const CryptoPP::Integer& s, const CryptoPP::ECPPoint& commitment,
+                     CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve);
+
+    // verifies a share against its vector commitment and blames the sender if it does not match
+    bool verifyShare(uint32_t senderID, uint32_t slot, const CryptoPP::Integer& r,
+                     const std::vector<CryptoPP::Integer>& slices, const CryptoPP::ECPPoint& commitment,
+                     CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve);
+
+    // verifies the added shares of a member against the sum of the commitments of all members
+    bool verifyAddedShares(uint32_t senderID, uint32_t memberIndex, uint32_t slot,
+                           const std::vector<CryptoPP::Integer>& rValues, const std::vector<CryptoPP::Integer>& slices,
+                           CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve);
+
+    // spot checks a share in the delayed verification mode, commitment returns the commitment of a slice,
+    // returns the number of audited slices or -1 if the sender has been blamed
+    int auditShare(uint32_t senderID, uint32_t slot, const std::vector<CryptoPP::Integer>& rValues,
+                   const std::vector<CryptoPP::Integer>& slices, double auditRate,
+                   const std::function<CryptoPP::ECPPoint(uint32_t)>& commitment,
+                   CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve,
+                   CryptoPP::RandomNumberGenerator& threadPRNG);
+
+    // sum of the commitments of all members to a slice of the given share
+    CryptoPP::ECPPoint addedCommitment(uint32_t slot, uint32_t share, uint32_t slice,
+                                       CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve);
+
+    // broadcasts the disclosed slices of an invalid share, a vector commitment discloses all slices
+    void injectBlameMessage(uint32_t suspectID, uint32_t slot, uint32_t slice, const CryptoPP::Integer& r,
+                            const std::vector<CryptoPP::Integer>& slices);
+
+    // transition to the init state after a blame message,
+    // in the fast recovery mode the remaining blame messages of the epoch are validated first
+    std::unique_ptr<DCState> abortRound();
 
     void handleBlameMessage(ReceivedMessage& blameMessage);
 
+    // exchanges the full commitments, which have been announced by their digests, in case of a dispute
+    int revealCommitments();
+
+    // decodes the commitments which have been kept in their wire encoding
+    void decodeCommitments();
+
+    // returns a received commitment, which is decoded from its wire encoding if necessary
+    CryptoPP::ECPPoint receivedCommitment(uint32_t memberIndex, uint32_t slot, uint32_t share, uint32_t slice,
+                                          CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve);
+
+    // broadcasts the padded payload slots in the hybrid mode
+    void payloadSharing();
+
+    // collects the padded payload slots of the other members
+    void payloadComputation();
+
+    // checks the reconstructed payload against the digest and the length transmitted in the secured round
+    bool payloadMatches(uint32_t slot, const std::vector<uint8_t>& digestSlot);
+
+    // exchanges whether the payloads matched their digests, returns true if they matched for all members
+    bool agreeOnPayloads(bool matches);
+
+    // writes the header of an initial round slot, which renews the lease for a message of the given size
+    void writeLease(uint8_t* lease, size_t messageSize);
+
+    // returns the final round of the renewed slots, nullptr if no slot has been renewed
+    std::unique_ptr<DCState> leasedRound(std::vector<std::vector<uint8_t>>& finalMessages);
+
     DCNetwork& DCNetwork_;
 
+    // snapshot of the ordered member list at the start of the round
+    std::shared_ptr<const MemberTable> members_;
+
     // DCNetwork size
     size_t k_;
 
+    // epoch of the preceding initial round
+    uint64_t epoch_;
+
     // the position in of the own nodeID in the ordered member list
     size_t nodeIndex_;
 
-    // index of the slot in the message vector
-    int slotIndex_;
+    // index of the slot in the message vector for each submitted message, -1 if the reservation failed
+    std::vector<int> slotIndices_;
 
     std::vector<std::pair<uint16_t, uint16_t>> slots_;
 
-    std::vector<CryptoPP::Integer> seedPrivateKeys_;
+    // private keys of the ephemeral seeds of each reservation
+    std::vector<std::vector<CryptoPP::Integer>> seedPrivateKeys_;
 
     std::vector<std::array<uint8_t, 32>> seeds_;
 
     std::vector<std::vector<std::vector<CryptoPP::Integer>>> shares_;
 
-    // pseudo random values for the commitments
+    // pseudo random values for the commitments,
+    // a single value per share if vector commitments are used
     std::vector<std::vector<std::vector<CryptoPP::Integer>>> rValues_;
 
-    // received commitments stored along with the corresponding memberID
-    std::unordered_map<uint32_t, std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>>> commitments_;
+    // generators of the vector commitments
+    std::shared_ptr<const VectorCommitment> generators_;
+
+    // received commitments indexed by the position of the sender in the member list
+    std::vector<std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>>> commitments_;
+
+    // wire encodings of the received commitments in the delayed verification mode,
+    // one buffer per member and slot, decoded only if a dispute requires them
+    std::vector<std::vector<std::vector<uint8_t>>> rawCommitments_;
 
-    // share and rvalue storage, required for delayed commitment validation
-    std::unordered_map<uint32_t, std::vector<std::vector<std::pair<CryptoPP::Integer, CryptoPP::Integer>>>> rs_;
-    std::unordered_map<uint32_t, std::vector<std::vector<std::pair<CryptoPP::Integer, CryptoPP::Integer>>>> RS_;
+    // wire encodings of the shares and rvalues per member and slot, required for delayed commitment validation
+    std::vector<std::vector<std::vector<uint8_t>>> rs_;
+    std::vector<std::vector<std::vector<uint8_t>>> RS_;
 
     // sum of all shares
     std::vector<std::vector<CryptoPP::Integer>> S;
 
-    // sum of all random blinding coefficients
+    // slots which have already been delivered during the result computation,
+    // only used if every share is verified against its commitments on receipt.
+    // A delivered slot remains delivered if the round is aborted later on, it is not delivered again
+    // since the senders remove their messages from the queue in the preparation and the epoch is not repeated.
+    std::vector<uint8_t> deliveredSlots_;
+
+    // sum of all random blinding coefficients, one per commitment
     std::vector<std::vector<CryptoPP::Integer>> R;
 
     CryptoPP::AutoSeededRandomPool PRNG;
@@ -79,6 +173,40 @@ private:
     CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP> curve;
 
     bool delayedVerification_;
+
+    // number of slices verified by the spot checks in this round
+    uint64_t auditedSlices_;
+
+    // determines whether only the digests of the encoded commitments are broadcasted
+    bool optimistic_;
+
+    // own encoded commitments, kept until the round is finished
+    std::vector<std::vector<uint8_t>> encodedCommitments_;
+
+    // digests of the encoded commitments indexed by the position of the sender in the member list
+    std::vector<std::vector<std::array<uint8_t, 32>>> commitmentDigests_;
+
+    // determines whether the secured round carries only the digests of the payloads
+    bool hybrid_;
+
+    // the reserved slots of the payloads in the hybrid mode
+    std::vector<std::pair<uint16_t, uint16_t>> payloadSlots_;
+
+    // sum of all padded payload slots
+    std::vector<std::vector<uint8_t>> payloads_;
+
+    size_t leaseSize_;
+
+    // number of preceding final rounds since the last reservation round
+    uint32_t leasedRounds_;
+
+    // slot of each own renewed lease and the private keys of its ephemeral seeds
+    std::vector<uint32_t> renewedSlots_;
+    std::vector<std::vector<CryptoPP::Integer>> leaseKeys_;
+
+    // verifies the received shares alongside the sharing in the speculative mode,
+    // declared last so that the workers are stopped before the data they access is destroyed
+    std::unique_ptr<AsyncVerifier> verifier_;
 };
 
 
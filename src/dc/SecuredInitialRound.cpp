@@ -2,6 +2,8 @@
 #include <thread>
 #include <cryptopp/oids.h>
 #include <numeric>
+#include <map>
+#include <algorithm>
 #include "SecuredInitialRound.h"
 #include "DCNetwork.h"
 #include "InitState.h"
@@ -10,15 +12,23 @@
 
 #include "FairnessProtocol.h"
 #include "../utils/Utils.h"
+#include "SeededShares.h"
+#include "SpotCheck.h"
+#include "BlameMessage.h"
+#include "AsyncVerifier.h"
 
 SecuredInitialRound::SecuredInitialRound(DCNetwork &DCNet)
-        : DCNetwork_(DCNet), k_(DCNetwork_.k()), numSlices_(std::ceil((8 + 33 * k_) / 31.0)), slotIndex_(-1) {
+        : DCNetwork_(DCNet), members_(DCNet.memberTable()), k_(DCNetwork_.k()),
+          epoch_(DCNet.nextEpoch()), numSlices_(std::ceil(DCNet.reservationSize() / 31.0)),
+          delayedVerification_(!DCNet.fullProtocol()), auditedSlices_(0),
+          optimistic_(DCNet.optimisticCommitments() && !DCNet.fullProtocol()) {
     curve_.Initialize(CryptoPP::ASN1::secp256k1());
 
-    if(!DCNet.fullProtocol())
-        delayedVerification_ = true;
+    if (DCNet.speculativeVerification() && !delayedVerification_)
+        verifier_ = std::make_unique<AsyncVerifier>(DCNet.numThreads());
+
     // determine the index of the own nodeID in the ordered member list
-    nodeIndex_ = std::distance(DCNetwork_.members().begin(), DCNetwork_.members().find(DCNetwork_.nodeID()));
+    nodeIndex_ = members_->index(DCNetwork_.nodeID());
 }
 
 SecuredInitialRound::~SecuredInitialRound() {}
@@ -34,7 +44,7 @@ std::unique_ptr<DCState> SecuredInitialRound::executeTask() {
     runtimes.push_back(elapsed.count());
 
     start = std::chrono::high_resolution_clock::now();
-    // generate and distribute the commitments
+    // generate and distribute the commitments and the shares
     SecuredInitialRound::sharingPartOne();
 
     finish = std::chrono::high_resolution_clock::now();
@@ -45,10 +55,7 @@ std::unique_ptr<DCState> SecuredInitialRound::executeTask() {
     int result = SecuredInitialRound::sharingPartTwo();
     // a blame message has been received
     if (result < 0) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
-        DCNetwork_.inbox().clear();
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
-        return std::make_unique<InitState>(DCNetwork_);
+        return SecuredInitialRound::abortRound();
     }
 
     // logging
@@ -59,42 +66,68 @@ std::unique_ptr<DCState> SecuredInitialRound::executeTask() {
 
     // collect and validate the final shares
     std::vector<std::vector<uint8_t>> finalMessageVector = SecuredInitialRound::resultComputation();
+
     // Check if the protocol's execution has been interrupted by a blame message
     if(finalMessageVector.size() == 0) {
         // a blame message indicates that a member may have been excluded from the group
         // therefore a transition to the init state is performed,
         // which will execute a group membership protocol
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
-        DCNetwork_.inbox().clear();
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
-        return std::make_unique<InitState>(DCNetwork_);
+        return SecuredInitialRound::abortRound();
     }
 
+    // both sharings contain 2k slots of (k-1) members
+    if (delayedVerification_ && (DCNetwork_.auditRate() > 0))
+        DCNetwork_.recordAudit(auditedSlices_, 2 * 2 * k_ * (k_ - 1) * numSlices_);
+
     // prepare the final round
     std::vector<std::pair<uint16_t, uint16_t>> slots;
     std::vector<std::array<uint8_t, 32>> receivedSeeds;
 
     // determine the non-empty slots in the message vector
-    // and calculate the index of the own slot if present
-    int finalSlotIndex = -1;
+    // and calculate the index of each own slot if present
+    std::vector<int> slotIndices(reservedSlots_.size(), -1);
     uint32_t invalidCRCs = 0;
+    // the shared slots are checked against the shared reservations, which the members announce in their own slots
+    bool sharedSlots = DCNetwork_.maxSlots() > 1;
+    uint32_t sharedReservations = 0;
+    uint32_t validSharedSlots = 0;
+    uint32_t invalidSharedSlots = 0;
     for (uint32_t slot = 0; slot < 2 * k_; slot++) {
         uint16_t round_identifier = (finalMessageVector[slot][4] << 8) | finalMessageVector[slot][5];
         uint16_t slotSize = (finalMessageVector[slot][6] << 8) | finalMessageVector[slot][7];
         if (slotSize > 0) {
             // verify the CRC
-            CRC32_.Update(&finalMessageVector[slot][4], 4 + 33 * k_);
+            CRC32_.Update(&finalMessageVector[slot][4], finalMessageVector[slot].size() - 4);
 
             bool valid = CRC32_.Verify(finalMessageVector[slot].data());
             if(!valid) {
-                invalidCRCs++;
+                // two members may reserve the same shared slot,
+                // which is distinguished from disruption once all own slots have been read
+                if ((slot < k_) || !sharedSlots)
+                    invalidCRCs++;
+                else
+                    invalidSharedSlots++;
             } else {
-                if (static_cast<uint32_t>(slotIndex_) == slot)
-                    finalSlotIndex = slots.size();
+                if (sharedSlots && (slot < k_)) {
+                    uint8_t announced = finalMessageVector[slot].back();
+                    // a member cannot reserve more shared slots than the others
+                    if (announced < DCNetwork_.maxSlots())
+                        sharedReservations += announced;
+                    else
+                        invalidCRCs++;
+                } else if (sharedSlots) {
+                    validSharedSlots++;
+                }
 
-                //decrypt and extract the own seed for the each slot
+                auto reservation = std::find(reservedSlots_.begin(), reservedSlots_.end(), slot);
+                if (reservation != reservedSlots_.end())
+                    slotIndices[reservation - reservedSlots_.begin()] = slots.size();
+
+                //decrypt and extract the own seed for the each slot,
+                // a compact reservation contains a single key for all members
+                uint32_t keyIndex = DCNetwork_.compactReservation() ? 0 : nodeIndex_;
                 CryptoPP::ECPPoint rG;
-                curve_.GetCurve().DecodePoint(rG, &finalMessageVector[slot][8 + 33 * nodeIndex_], 33);
+                curve_.GetCurve().DecodePoint(rG, &finalMessageVector[slot][8 + 33 * keyIndex], 33);
 
                 // Perform an ephemeral ECDH KE with the given public key
                 CryptoPP::Integer sharedSecret = curve_.GetCurve().ScalarMultiply(rG, DCNetwork_.privateKey()).x;
@@ -110,13 +143,32 @@ std::unique_ptr<DCState> SecuredInitialRound::executeTask() {
         }
     }
 
+    if (sharedSlots)
+        invalidCRCs += DCNetwork_.disruptedSharedSlots(invalidSharedSlots, validSharedSlots, sharedReservations);
+
+    // the fairness protocol requires the full commitments
+    if (optimistic_ && ((invalidCRCs > std::floor(k_/2)) || (DCNetwork_.securityLevel() == ProofOfFairness))) {
+        if (SecuredInitialRound::revealCommitments() < 0) {
+            return SecuredInitialRound::abortRound();
+        }
+    }
+
+    // the fairness protocol operates on the decoded commitments
+    if (delayedVerification_ && ((invalidCRCs > std::floor(k_/2)) || (DCNetwork_.securityLevel() == ProofOfFairness)))
+        SecuredInitialRound::decodeCommitments();
+
+    // the fairness protocol covers the own slot of the first submitted message
+    int slotIndex = reservedSlots_.empty() ? -1 : static_cast<int>(reservedSlots_[0]);
+
     if(invalidCRCs > std::floor(k_/2)) {
         std::cout << "More than k/2 invalid CRCs detected." << std::endl;
         std::cout << "Switching to Proof of Fairness Protocol" << std::endl;
-        return std::make_unique<FairnessProtocol>(DCNetwork_, numSlices_, slotIndex_, std::move(rValues_),
+        return std::make_unique<FairnessProtocol>(DCNetwork_, numSlices_, slotIndex, std::move(rValues_),
                                                   std::move(commitments_));
     }
 
+    bool sending = std::any_of(slotIndices.begin(), slotIndices.end(), [](int slotIndex) { return slotIndex > -1; });
+
     // Logging
     if (DCNetwork_.logging() && (slots.size() != 0) && (DCNetwork_.securityLevel() != ProofOfFairness)) {
         auto finish = std::chrono::high_resolution_clock::now();
@@ -134,7 +186,7 @@ std::unique_ptr<DCState> SecuredInitialRound::executeTask() {
         // round 1
         log[4 * sizeof(double) + 1] = 1;
         //sending
-        log[4 * sizeof(double) + 2] = (finalSlotIndex > -1) ? 1 : 0;
+        log[4 * sizeof(double) + 2] = sending ? 1 : 0;
         //numThreads
         log[4 * sizeof(double) + 3] = DCNetwork_.numThreads();
 
@@ -142,44 +194,49 @@ std::unique_ptr<DCState> SecuredInitialRound::executeTask() {
         DCNetwork_.outbox().push(std::move(logMessage));
     }
 
-    if (finalSlotIndex > -1)
-        std::cout << "Node " << DCNetwork_.nodeID() << ": sending in slot " << std::dec << finalSlotIndex << std::endl;
+    for (int finalSlotIndex : slotIndices) {
+        if (finalSlotIndex > -1)
+            std::cout << "Node " << DCNetwork_.nodeID() << ": sending in slot " << std::dec << finalSlotIndex << std::endl;
+    }
 
     // for benchmarks only
     if(DCNetwork_.securityLevel() == ProofOfFairness)
-        return std::make_unique<FairnessProtocol>(DCNetwork_, numSlices_, slotIndex_, std::move(rValues_),
+        return std::make_unique<FairnessProtocol>(DCNetwork_, numSlices_, slotIndex, std::move(rValues_),
                                                  std::move(commitments_));
 
     // if no member wants to send a message, return to the Ready state
     if (slots.size() == 0) {
         std::cout << "No sender in this round" << std::endl;
         std::this_thread::sleep_for(std::chrono::seconds(1));
+        if (DCNetwork_.securityLevel() == Adaptive) {
+            DCNetwork_.adaptiveSecurity().cleanRound();
+            return InitState::initialRound(DCNetwork_);
+        }
         return std::make_unique<SecuredInitialRound>(DCNetwork_);
     } else {
-        return std::make_unique<SecuredFinalRound>(DCNetwork_, finalSlotIndex, std::move(slots),
+        return std::make_unique<SecuredFinalRound>(DCNetwork_, std::move(slotIndices), std::move(slots),
                                                    std::move(seedPrivateKeys_),
-                                                   std::move(receivedSeeds));
+                                                   std::move(receivedSeeds), epoch_);
     }
 }
 
 void SecuredInitialRound::preparation() {
-    // check if there is a submitted message and determine it's length,
-    // but don't remove it from the message queue just yet
-    uint16_t l = 0;
-    if (!DCNetwork_.submittedMessages().empty()) {
-        size_t msgSize = DCNetwork_.submittedMessages().front().size();
-        // ensure that the message size does not exceed 2^16 Bytes
-        l = msgSize > USHRT_MAX ? USHRT_MAX : msgSize;
-    }
+    size_t slotSize = DCNetwork_.reservationSize();
 
-    size_t slotSize = 8 + 33 * k_;
+    // reserve a slot for each of the first submitted messages,
+    // but don't remove them from the message queue just yet
+    reservedSlots_ = DCNetwork_.reserveSlots(PRNG);
+    std::vector<std::vector<CryptoPP::Integer>> messageSlices(reservedSlots_.size());
+    seedPrivateKeys_.resize(reservedSlots_.size());
 
-    std::vector<CryptoPP::Integer> messageSlices;
+    for (uint32_t reservation = 0; reservation < reservedSlots_.size(); reservation++) {
+        // ensure that the message size does not exceed 2^16 Bytes,
+        // the submitted messages leave room for the lease header of the final round
+        size_t msgSize = DCNetwork_.leaseSize() + DCNetwork_.submittedMessages()[reservation].size();
+        uint16_t l = msgSize > USHRT_MAX ? USHRT_MAX : msgSize;
 
-    if (l > 0) {
         std::vector<uint8_t> messageSlot(slotSize);
         uint16_t r = PRNG.GenerateWord32(0, USHRT_MAX);
-        slotIndex_ = nodeIndex_; //PRNG.GenerateWord32(0, 2 * k_ - 1);
 
         // set the values in Big Endian format
         messageSlot[4] = static_cast<uint8_t>((r & 0xFF00) >> 8);
@@ -188,64 +245,104 @@ void SecuredInitialRound::preparation() {
         messageSlot[7] = static_cast<uint8_t>((l & 0x00FF));
 
         // generate k random seeds, required for the commitments in the second round
-        seedPrivateKeys_.reserve(k_);
-        for (auto it = DCNetwork_.members().begin(); it != DCNetwork_.members().end(); it++) {
-            uint32_t memberIndex = std::distance(DCNetwork_.members().begin(), it);
-
-            // generate an ephemeral EC key pair
+        seedPrivateKeys_[reservation].reserve(k_);
+        if (DCNetwork_.compactReservation()) {
+            // the ECDH with the public key of each member yields a distinct seed per member,
+            // the same private key is stored for each member
             CryptoPP::Integer r(PRNG, CryptoPP::Integer::One(), curve_.GetMaxExponent());
             CryptoPP::ECPPoint rG = curve_.ExponentiateBase(r);
 
-            curve_.GetCurve().EncodePoint(&messageSlot[8 + 33 * memberIndex], rG, true);
+            curve_.GetCurve().EncodePoint(&messageSlot[8], rG, true);
+            seedPrivateKeys_[reservation].assign(k_, r);
+        } else {
+            for (uint32_t memberIndex = 0; memberIndex < k_; memberIndex++) {
+                // generate an ephemeral EC key pair
+                CryptoPP::Integer r(PRNG, CryptoPP::Integer::One(), curve_.GetMaxExponent());
+                CryptoPP::ECPPoint rG = curve_.ExponentiateBase(r);
 
-            // store the seed
-            seedPrivateKeys_.push_back(std::move(r));
+                curve_.GetCurve().EncodePoint(&messageSlot[8 + 33 * memberIndex], rG, true);
+
+                // store the seed
+                seedPrivateKeys_[reservation].push_back(std::move(r));
+            }
         }
 
+        // the own slot announces the number of shared slots reserved in addition
+        if ((reservation == 0) && (DCNetwork_.maxSlots() > 1))
+            messageSlot.back() = reservedSlots_.size() - 1;
+
         // Calculate the CRC
-        CRC32_.Update(&messageSlot[4], 4 + 33 * k_);
+        CRC32_.Update(&messageSlot[4], slotSize - 4);
         CRC32_.Final(messageSlot.data());
 
         // subdivide the message into slices
-        messageSlices.reserve(numSlices_);
+        messageSlices[reservation].reserve(numSlices_);
         for (uint32_t i = 0; i < numSlices_; i++) {
             size_t sliceSize = ((slotSize - 31 * i > 31) ? 31 : slotSize - 31 * i);
             CryptoPP::Integer slice(&messageSlot[31 * i], sliceSize);
-            messageSlices.push_back(std::move(slice));
+            messageSlices[reservation].push_back(std::move(slice));
         }
     }
 
+    // in the seeded mode the own share takes the remainder, since all shares sent to other members
+    // have to be expanded from seeds
+    bool seeded = DCNetwork_.seededShares();
+    uint32_t remainder = seeded ? nodeIndex_ : k_ - 1;
+    if (seeded) {
+        shareSeeds_.resize(2 * k_);
+        rValues_.resize(2 * k_);
+    }
+
     shares_.resize(2*k_);
     for (uint32_t slot = 0; slot < 2 * k_; slot++) {
         shares_[slot].resize(k_);
-        shares_[slot][k_ - 1].reserve(numSlices_);
-        // initialize the slices of the k-th share with zeroes
-        // except the slices of the own message slot
-        if (static_cast<uint32_t>(slotIndex_) == slot) {
+        shares_[slot][remainder].reserve(numSlices_);
+        // initialize the slices of the remainder share with zeroes
+        // except the slices of the own message slots
+        auto reservation = std::find(reservedSlots_.begin(), reservedSlots_.end(), slot);
+        if (reservation != reservedSlots_.end()) {
             for (uint32_t slice = 0; slice < numSlices_; slice++)
-                shares_[slot][k_ - 1].push_back(messageSlices[slice]);
+                shares_[slot][remainder].push_back(messageSlices[reservation - reservedSlots_.begin()][slice]);
         } else {
             for (uint32_t slice = 0; slice < numSlices_; slice++)
-                shares_[slot][k_ - 1].push_back(CryptoPP::Integer::Zero());
+                shares_[slot][remainder].push_back(CryptoPP::Integer::Zero());
+        }
+
+        if (seeded) {
+            shareSeeds_[slot].resize(k_);
+            rValues_[slot].resize(k_);
         }
 
-        // fill the first slices of the first k-1 shares with random values
-        // and subtract the values from the corresponding slices in the k-th share
-        for (uint32_t share = 0; share < k_ - 1; share++) {
-            shares_[slot][share].reserve(numSlices_);
+        // fill the slices of the other k-1 shares with random values
+        // and subtract the values from the corresponding slices in the remainder share
+        for (uint32_t share = 0; share < k_; share++) {
+            if (share == remainder)
+                continue;
 
-            for (uint32_t slice = 0; slice < numSlices_; slice++) {
-                CryptoPP::Integer r(PRNG, CryptoPP::Integer::One(), curve_.GetMaxExponent());
-                // subtract the value from the corresponding slice in the k-th share
-                shares_[slot][k_ - 1][slice] -= r;
-                // store the random value in the slice of this share
-                shares_[slot][share].push_back(std::move(r));
+            if (seeded) {
+                // expand the share and the blinding factors from a fresh seed
+                PRNG.GenerateBlock(shareSeeds_[slot][share].data(), shareSeeds_[slot][share].size());
+                SeededShares::expand(shareSeeds_[slot][share], numSlices_, curve_.GetMaxExponent(),
+                                     rValues_[slot][share], &shares_[slot][share]);
+
+                for (uint32_t slice = 0; slice < numSlices_; slice++)
+                    shares_[slot][remainder][slice] -= shares_[slot][share][slice];
+            } else {
+                shares_[slot][share].reserve(numSlices_);
+
+                for (uint32_t slice = 0; slice < numSlices_; slice++) {
+                    CryptoPP::Integer r(PRNG, CryptoPP::Integer::One(), curve_.GetMaxExponent());
+                    // subtract the value from the corresponding slice in the remainder share
+                    shares_[slot][remainder][slice] -= r;
+                    // store the random value in the slice of this share
+                    shares_[slot][share].push_back(std::move(r));
+                }
             }
         }
 
-        // reduce the slices in the k-th share
+        // reduce the slices in the remainder share
         for (uint32_t slice = 0; slice < numSlices_; slice++)
-            shares_[slot][k_ - 1][slice] = shares_[slot][k_ - 1][slice].Modulo(curve_.GetGroupOrder());
+            shares_[slot][remainder][slice] = shares_[slot][remainder][slice].Modulo(curve_.GetGroupOrder());
     }
 
     // store the slices of the own share in S
@@ -265,6 +362,8 @@ void SecuredInitialRound::sharingPartOne() {
 
     size_t encodedPointSize = curve_.GetCurve().EncodedPointSize(true);
     std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>> commitmentCube(2 * k_);
+    if (optimistic_)
+        encodedCommitments_.resize(2 * k_);
 
     std::mutex threadMutex;
     std::list<std::thread> threads_;
@@ -298,25 +397,28 @@ void SecuredInitialRound::sharingPartOne() {
 
                 uint32_t offset = 2;
                 for (uint32_t share = 0; share < k_; share++) {
+                    // the blinding factors of seeded shares have already been expanded
+                    bool expanded = DCNetwork_.seededShares() && (share != nodeIndex_);
+
                     rValues_[slot][share].reserve(numSlices_);
                     commitmentCube[slot][share].reserve(numSlices_);
 
                     for (uint32_t slice = 0; slice < numSlices_; slice++, offset += encodedPointSize) {
 
-                        if(DCNetwork_.preparedCommitments().size() > 0 && (static_cast<int>(slot) != slotIndex_)) {
+                        if(!expanded && DCNetwork_.preparedCommitments().size() > 0
+                           && (std::find(reservedSlots_.begin(), reservedSlots_.end(), slot) == reservedSlots_.end())) {
                             // use the prepared values
                             rValues_[slot][share].push_back(DCNetwork_.preparedCommitments()[slot][share][slice].first);
                             commitmentCube[slot][share].push_back(DCNetwork_.preparedCommitments()[slot][share][slice].second);
                         } else {
-                            CryptoPP::Integer r(PRNG, CryptoPP::Integer::One(), threadCurve.GetMaxExponent());
-                            rValues_[slot][share].push_back(std::move(r));
-
-                            CryptoPP::ECPPoint rG = threadCurve.GetCurve().Multiply(rValues_[slot][share][slice], G);
-                            CryptoPP::ECPPoint sH = threadCurve.GetCurve().Multiply(shares_[slot][share][slice], H);
-                            CryptoPP::ECPPoint commitment = threadCurve.GetCurve().Add(rG, sH);
+                            if(!expanded) {
+                                CryptoPP::Integer r(PRNG, CryptoPP::Integer::One(), threadCurve.GetMaxExponent());
+                                rValues_[slot][share].push_back(std::move(r));
+                            }
 
-                            // store the commitment
-                            commitmentCube[slot][share].push_back(std::move(commitment));
+                            // generate and store the commitment
+                            commitmentCube[slot][share].push_back(SpotCheck::commit(threadCurve,
+                                    rValues_[slot][share][slice], shares_[slot][share][slice]));
                         }
                         // add the rValue for the own share to the sum of rValues
                         if(share == nodeIndex_)
@@ -329,287 +431,351 @@ void SecuredInitialRound::sharingPartOne() {
                     }
                 }
 
-                auto position = DCNetwork_.members().find(DCNetwork_.nodeID());
-                for (uint32_t member = 0; member < k_ - 1; member++) {
-                    position++;
-                    if (position == DCNetwork_.members().end())
-                        position = DCNetwork_.members().begin();
+                if (optimistic_) {
+                    // broadcast only the digest, the encoded commitments are revealed in case of a dispute
+                    std::array<uint8_t, 32> digest = utils::sha256Digest(encodedCommitments);
+                    encodedCommitments_[slot] = std::move(encodedCommitments);
+
+                    encodedCommitments.assign(2 + digest.size(), 0);
+                    encodedCommitments[0] = (slot & 0xFF00) >> 8;
+                    encodedCommitments[1] = (slot & 0x00FF);
+                    std::copy(digest.begin(), digest.end(), &encodedCommitments[2]);
+                }
 
-                    OutgoingMessage commitBroadcast(position->second.connectionID(), InitialRoundCommitments,
+                for (uint32_t member = 1; member < k_; member++) {
+                    uint32_t memberIndex = (nodeIndex_ + member) % k_;
+
+                    OutgoingMessage commitBroadcast(members_->connectionID(memberIndex),
+                                                    optimistic_ ? InitialRoundCommitmentDigest : InitialRoundCommitments,
                                                     DCNetwork_.nodeID(), encodedCommitments);
-                    DCNetwork_.outbox().push(std::move(commitBroadcast));
+                    DCNetwork_.send(std::move(commitBroadcast), epoch_);
                 }
+
+                // the shares of a slot depend only on its own commitments
+                SecuredInitialRound::sendShares(slot);
             }
         });
         threads_.push_back(std::move(commitThread));
     }
 
     // prepare the commitment storage
-    commitments_.reserve(k_);
-    for (auto member = DCNetwork_.members().begin(); member != DCNetwork_.members().end(); member++) {
-        if (member->first != DCNetwork_.nodeID()) {
-            std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>> commitmentCube(2*k_);
+    commitments_.assign(k_, std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>>(2 * k_));
+    if (delayedVerification_)
+        rawCommitments_.assign(k_, std::vector<std::vector<uint8_t>>(2 * k_));
+    if (optimistic_)
+        commitmentDigests_.assign(k_, std::vector<std::array<uint8_t, 32>>(2 * k_));
 
-            commitments_.insert(std::pair(member->second.nodeID(), std::move(commitmentCube)));
+    for (auto &t : threads_)
+        t.join();
+
+    commitments_[nodeIndex_] = std::move(commitmentCube);
+}
+
+void SecuredInitialRound::sendShares(uint32_t slot) {
+    for (uint32_t member = 1; member < k_; member++) {
+        uint32_t memberIndex = (nodeIndex_ + member) % k_;
+        std::vector<uint8_t> sharingMessage;
+        if (DCNetwork_.seededShares()) {
+            // the seed suffices to expand the share and the blinding factors
+            sharingMessage.resize(2 + 32);
+            std::copy(shareSeeds_[slot][memberIndex].begin(), shareSeeds_[slot][memberIndex].end(),
+                      &sharingMessage[2]);
+        } else {
+            sharingMessage.resize(2 + 64 * numSlices_);
+            for (uint32_t slice = 0, offset = 2; slice < numSlices_; slice++, offset += 64) {
+                rValues_[slot][memberIndex][slice].Encode(&sharingMessage[offset], 32);
+                shares_[slot][memberIndex][slice].Encode(&sharingMessage[offset + 32], 32);
+            }
         }
+        sharingMessage[0] = (slot & 0xFF00) >> 8;
+        sharingMessage[1] = (slot & 0x00FF);
+
+        OutgoingMessage rsMessage(members_->connectionID(memberIndex), InitialRoundFirstSharing, DCNetwork_.nodeID(),
+                                  sharingMessage);
+        DCNetwork_.send(std::move(rsMessage), epoch_);
     }
+}
 
-    for (auto &t : threads_)
-        t.join();
+int SecuredInitialRound::sharingPartTwo() {
+    if(delayedVerification_)
+        rs_.assign(k_, std::vector<std::vector<uint8_t>>(2 * k_));
 
-    commitments_.insert(std::pair(DCNetwork_.nodeID(), std::move(commitmentCube)));
+    // Each share depends only on the commitments of its sender for the same slot,
+    // and the added shares of a slot are broadcasted as soon as all shares of the slot have been accumulated.
+    // The shares are verified only against the commitments, therefore only the delayed verification
+    // without spot checks can accumulate a share before the corresponding commitments have been received.
+    bool commitmentsRequired = !delayedVerification_ || (DCNetwork_.auditRate() > 0);
 
-    threads_.clear();
-    uint32_t remainingCommitments = 2 * k_ * (k_ - 1);
+    // the commitments which have been received from each member
+    std::vector<std::vector<bool>> receivedCommitments(k_, std::vector<bool>(2 * k_, false));
+    // shares which have been received before the corresponding commitments, keyed by member index and slot
+    std::map<std::pair<uint32_t, uint32_t>, ReceivedMessage> pendingShares;
+
+    std::vector<uint32_t> remainingSlotShares(2 * k_, k_ - 1);
+
+    std::list<std::future<int>> futures_;
+    std::mutex threadMutex;
+    // commitments and shares of all slots from the other k-1 members
+    uint32_t remainingMessages = 2 * 2 * k_ * (k_ - 1);
 
     for (uint32_t t = 0; t < DCNetwork_.numThreads(); t++) {
-        std::thread commitThread([&]() {
+        std::future<int> future = std::async(std::launch::async, [&]() {
             CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP> threadCurve;
             threadCurve.Initialize(CryptoPP::ASN1::secp256k1());
+            CryptoPP::AutoSeededRandomPool threadPRNG;
 
             for (;;) {
                 {
                     std::lock_guard<std::mutex> lock(threadMutex);
-                    if (remainingCommitments > 0)
-                        remainingCommitments--;
+                    if (remainingMessages > 0)
+                        remainingMessages--;
                     else
                         break;
                 }
-                auto commitBroadcast = DCNetwork_.inbox().pop();
-                if (commitBroadcast.msgType() == InitialRoundCommitments) {
-
-                    std::vector<std::vector<CryptoPP::ECPPoint>> commitmentMatrix;
-                    commitmentMatrix.resize(k_);
-                    for (auto &share : commitmentMatrix)
-                        share.reserve(numSlices_);
-
-                    uint32_t slot = (commitBroadcast.body()[0] << 8) | commitBroadcast.body()[1];
-                    uint32_t offset = 2;
-                    for (uint32_t share = 0; share < k_; share++) {
-                        for (uint32_t slice = 0; slice < numSlices_; slice++, offset += encodedPointSize) {
-                            CryptoPP::ECPPoint commitment;
-                            threadCurve.GetCurve().DecodePoint(commitment, &commitBroadcast.body()[offset],
-                                                               encodedPointSize);
-
-                            commitmentMatrix[share].push_back(std::move(commitment));
-                        }
+                auto message = DCNetwork_.inbox(epoch_).pop();
+
+                std::vector<ReceivedMessage> readyShares;
+                bool sharingMessage = (message.msgType() == InitialRoundCommitments)
+                                      || (message.msgType() == InitialRoundCommitmentDigest)
+                                      || (message.msgType() == InitialRoundFirstSharing);
+                if (sharingMessage && !SecuredInitialRound::validSharingMessage(
+                        message, threadCurve.GetCurve().EncodedPointSize(true))) {
+                    // the malformed message does not replace an expected one
+                    std::lock_guard<std::mutex> lock(threadMutex);
+                    remainingMessages++;
+                } else if ((message.msgType() == InitialRoundCommitments)
+                    || (message.msgType() == InitialRoundCommitmentDigest)) {
+                    uint32_t slot = (message.body()[0] << 8) | message.body()[1];
+                    uint32_t memberIndex = members_->index(message.senderID());
+
+                    SecuredInitialRound::storeCommitments(message, threadCurve, threadMutex);
+
+                    // release a share which has been waiting for these commitments
+                    std::lock_guard<std::mutex> lock(threadMutex);
+                    receivedCommitments[memberIndex][slot] = true;
+                    auto pending = pendingShares.find(std::pair(memberIndex, slot));
+                    if (pending != pendingShares.end()) {
+                        readyShares.push_back(std::move(pending->second));
+                        pendingShares.erase(pending);
                     }
+                } else if (message.msgType() == InitialRoundFirstSharing) {
+                    uint32_t slot = (message.body()[0] << 8) | message.body()[1];
+                    uint32_t memberIndex = members_->index(message.senderID());
+
                     std::lock_guard<std::mutex> lock(threadMutex);
-                    commitments_[commitBroadcast.senderID()][slot] = std::move(commitmentMatrix);
+                    if (commitmentsRequired && !receivedCommitments[memberIndex][slot])
+                        pendingShares.insert(std::pair(std::pair(memberIndex, slot), std::move(message)));
+                    else
+                        readyShares.push_back(std::move(message));
                 } else {
-                    DCNetwork_.inbox().push(commitBroadcast);
+                    DCNetwork_.inbox(epoch_).push(message);
                     std::this_thread::sleep_for(std::chrono::milliseconds(1));
 
                     std::lock_guard<std::mutex> lock(threadMutex);
-                    remainingCommitments++;
+                    remainingMessages++;
                 }
-            }
-        });
-        threads_.push_back(std::move(commitThread));
-    }
 
-    for (auto &t : threads_)
-        t.join();
-
-    threads_.clear();
+                for (auto &sharingMessage : readyShares) {
+                    uint32_t slot = (sharingMessage.body()[0] << 8) | sharingMessage.body()[1];
 
-    currentSlot = 0;
-    for (uint32_t t = 0; t < DCNetwork_.numThreads(); t++) {
-        std::thread sharingThread([&]() {
-            for(;;) {
-                uint32_t slot;
-                {
-                    std::lock_guard<std::mutex> lock(threadMutex);
-                    if(currentSlot < 2*k_) {
-                        slot = currentSlot;
-                        currentSlot++;
-                    } else {
-                        break;
-                    }
-                }
-                auto position = DCNetwork_.members().find(DCNetwork_.nodeID());
-                for (uint32_t member = 0; member < k_ - 1; member++) {
-                    position++;
-                    if (position == DCNetwork_.members().end())
-                        position = DCNetwork_.members().begin();
-
-                    uint32_t memberIndex = std::distance(DCNetwork_.members().begin(), position);
-                    std::vector<uint8_t> sharingMessage(2 + 64 * numSlices_);
-                    sharingMessage[0] = (slot & 0xFF00) >> 8;
-                    sharingMessage[1] = (slot & 0x00FF);
-                    for (uint32_t slice = 0, offset = 2; slice < numSlices_; slice++, offset += 64) {
-                        rValues_[slot][memberIndex][slice].Encode(&sharingMessage[offset], 32);
-                        shares_[slot][memberIndex][slice].Encode(&sharingMessage[offset + 32], 32);
+                    if (SecuredInitialRound::accumulateShare(sharingMessage, threadCurve, threadPRNG, threadMutex) < 0) {
+                        std::lock_guard<std::mutex> lock(threadMutex);
+                        remainingMessages = 0;
+                        return -1;
                     }
 
-                    OutgoingMessage rsMessage(position->second.connectionID(), InitialRoundFirstSharing, DCNetwork_.nodeID(),
-                                              sharingMessage);
-                    DCNetwork_.outbox().push(std::move(rsMessage));
+                    bool slotComplete;
+                    {
+                        std::lock_guard<std::mutex> lock(threadMutex);
+                        remainingSlotShares[slot]--;
+                        slotComplete = (remainingSlotShares[slot] == 0);
+                    }
+                    // the second sharing of a slot is broadcasted speculatively,
+                    // unless an invalid share has already been detected
+                    if (slotComplete && !(verifier_ && verifier_->failed()))
+                        SecuredInitialRound::broadcastAddedShares(slot, threadCurve);
                 }
             }
+            return 0;
         });
-        threads_.push_back(std::move(sharingThread));
+        futures_.push_back(std::move(future));
     }
 
-    for(auto& t : threads_)
-        t.join();
+    // check if an invalid commitment has been detected
+    for (auto &f : futures_)
+        if (f.get() < 0)
+            return -1;
+
+    if (verifier_ && verifier_->failed())
+        return -1;
+
+    return 0;
 }
 
-int SecuredInitialRound::sharingPartTwo() {
-    if(delayedVerification_) {
-        rs_.reserve(k_-1);
-        for (auto member = DCNetwork_.members().begin(); member != DCNetwork_.members().end(); member++) {
-            if (member->first != DCNetwork_.nodeID()) {
-                std::vector<std::vector<std::pair<CryptoPP::Integer, CryptoPP::Integer>>> rsMatrix(2*k_);
-                for(uint32_t slot = 0; slot < 2*k_; slot++)
-                    rsMatrix[slot].reserve(numSlices_);
-                rs_.insert(std::pair(member->second.nodeID(), std::move(rsMatrix)));
+bool SecuredInitialRound::validSharingMessage(ReceivedMessage& message, size_t encodedPointSize) {
+    int senderIndex = members_->index(message.senderID());
+    if ((senderIndex < 0) || (static_cast<size_t>(senderIndex) == nodeIndex_)) {
+        std::cout << "Error: dropped a sharing message of a non-member" << std::endl;
+        return false;
+    }
+
+    size_t expectedSize;
+    if (message.msgType() == InitialRoundCommitments)
+        expectedSize = 2 + k_ * numSlices_ * encodedPointSize;
+    else if (message.msgType() == InitialRoundCommitmentDigest)
+        expectedSize = 2 + 32;
+    else
+        expectedSize = DCNetwork_.seededShares() ? 2 + 32 : 2 + 64 * numSlices_;
+
+    uint32_t slot = (message.body().size() >= 2) ? (message.body()[0] << 8) | message.body()[1] : 0;
+    if ((message.body().size() != expectedSize) || (slot >= 2 * k_)) {
+        std::cout << "Error: dropped a malformed sharing message" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void SecuredInitialRound::storeCommitments(ReceivedMessage& commitBroadcast,
+                                           CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve,
+                                           std::mutex& threadMutex) {
+    size_t encodedPointSize = threadCurve.GetCurve().EncodedPointSize(true);
+    uint32_t slot = (commitBroadcast.body()[0] << 8) | commitBroadcast.body()[1];
+    uint32_t memberIndex = members_->index(commitBroadcast.senderID());
+
+    if ((commitBroadcast.msgType() == InitialRoundCommitments) && delayedVerification_) {
+        // the commitments are not validated, therefore they are kept in their wire encoding
+        std::lock_guard<std::mutex> lock(threadMutex);
+        rawCommitments_[memberIndex][slot] = std::move(commitBroadcast.body());
+    } else if (commitBroadcast.msgType() == InitialRoundCommitments) {
+        std::vector<std::vector<CryptoPP::ECPPoint>> commitmentMatrix;
+        commitmentMatrix.resize(k_);
+        for (auto &share : commitmentMatrix)
+            share.reserve(numSlices_);
+
+        uint32_t offset = 2;
+        for (uint32_t share = 0; share < k_; share++) {
+            for (uint32_t slice = 0; slice < numSlices_; slice++, offset += encodedPointSize) {
+                CryptoPP::ECPPoint commitment;
+                threadCurve.GetCurve().DecodePoint(commitment, &commitBroadcast.body()[offset], encodedPointSize);
+
+                commitmentMatrix[share].push_back(std::move(commitment));
             }
         }
+        std::lock_guard<std::mutex> lock(threadMutex);
+        commitments_[memberIndex][slot] = std::move(commitmentMatrix);
+    } else {
+        std::lock_guard<std::mutex> lock(threadMutex);
+        std::copy(&commitBroadcast.body()[2], &commitBroadcast.body()[2] + 32,
+                  commitmentDigests_[memberIndex][slot].begin());
     }
-    // collect the shares from the other k-1 members and validate them using the broadcasted commitments
-    std::list<std::future<int>> futures_;
-    std::mutex threadMutex;
-    uint32_t remainingShares = 2 * k_ * (k_-1);
+}
 
-    for (uint32_t t = 0; t < DCNetwork_.numThreads(); t++) {
-        std::future<int> future = std::async(std::launch::async, [&]() {
-            CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP> threadCurve;
-            threadCurve.Initialize(CryptoPP::ASN1::secp256k1());
+int SecuredInitialRound::accumulateShare(ReceivedMessage& sharingMessage,
+                                         CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve,
+                                         CryptoPP::RandomNumberGenerator& threadPRNG, std::mutex& threadMutex) {
+    // without the validation of the commitments only a random fraction of the slices is verified
+    double auditRate = delayedVerification_ ? DCNetwork_.auditRate() : 0;
 
-            for (;;) {
-                {
-                    std::lock_guard<std::mutex> lock(threadMutex);
-                    if (remainingShares > 0)
-                        remainingShares--;
-                    else
-                        break;
-                }
-                auto sharingMessage = DCNetwork_.inbox().pop();
-                if (sharingMessage.msgType() == InitialRoundFirstSharing) {
-
-                    uint32_t slot = (sharingMessage.body()[0] << 8) | sharingMessage.body()[1];
+    uint32_t slot = (sharingMessage.body()[0] << 8) | sharingMessage.body()[1];
 
-                    for (uint32_t slice = 0, offset = 2; slice < numSlices_; slice++, offset += 64) {
-                        CryptoPP::Integer r(&sharingMessage.body()[offset], 32);
-                        CryptoPP::Integer s(&sharingMessage.body()[offset + 32], 32);
+    std::vector<CryptoPP::Integer> rValues;
+    std::vector<CryptoPP::Integer> slices;
+    if (DCNetwork_.seededShares()) {
+        std::array<uint8_t, 32> seed;
+        std::copy(&sharingMessage.body()[2], &sharingMessage.body()[2] + 32, seed.begin());
+        SeededShares::expand(seed, numSlices_, threadCurve.GetMaxExponent(), rValues, &slices);
+    } else {
+        rValues.reserve(numSlices_);
+        slices.reserve(numSlices_);
+        for (uint32_t slice = 0, offset = 2; slice < numSlices_; slice++, offset += 64) {
+            rValues.push_back(CryptoPP::Integer(&sharingMessage.body()[offset], 32));
+            slices.push_back(CryptoPP::Integer(&sharingMessage.body()[offset + 32], 32));
+        }
+    }
 
-                        if(delayedVerification_) {
-                            rs_[sharingMessage.senderID()][slot].push_back(std::pair(r,s));
-                        } else {
-                            // verify that the corresponding commitment is valid
-                            CryptoPP::ECPPoint rG = threadCurve.GetCurve().Multiply(r, G);
-                            CryptoPP::ECPPoint sH = threadCurve.GetCurve().Multiply(s, H);
-                            CryptoPP::ECPPoint commitment = threadCurve.GetCurve().Add(rG, sH);
-
-                            // if the commitment is invalid, blame the sender
-                            if ((commitment.x !=
-                                 commitments_[sharingMessage.senderID()][slot][DCNetwork_.nodeID()][slice].x)
-                                || (commitment.y !=
-                                    commitments_[sharingMessage.senderID()][slot][DCNetwork_.nodeID()][slice].y)) {
-
-                                SecuredInitialRound::injectBlameMessage(sharingMessage.senderID(), slot, slice, r, s);
-
-                                std::lock_guard<std::mutex> lock(threadMutex);
-                                remainingShares = 0;
-                                return -1;
-                            }
-                        }
+    uint32_t senderID = sharingMessage.senderID();
+    uint32_t memberIndex = members_->index(senderID);
+    if (auditRate > 0) {
+        int numAudited = SecuredInitialRound::auditShare(senderID, slot, rValues, slices, auditRate,
+                [&](uint32_t slice) {
+                    return SecuredInitialRound::receivedCommitment(memberIndex, slot, nodeIndex_, slice, threadCurve);
+                }, threadCurve, threadPRNG);
+        if (numAudited < 0)
+            return -1;
 
-                        std::lock_guard<std::mutex> lock(threadMutex);
-                        R[slot][slice] += r;
-                        S[slot][slice] += s;
-                    }
-                } else {
-                    DCNetwork_.inbox().push(sharingMessage);
-                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        std::lock_guard<std::mutex> lock(threadMutex);
+        auditedSlices_ += numAudited;
+    }
 
-                    std::lock_guard<std::mutex> lock(threadMutex);
-                    remainingShares++;
-                }
+    // verify the share on the verification workers while the sharing proceeds
+    if (verifier_) {
+        verifier_->submit([this, senderID, memberIndex, slot, rValues, slices](
+                CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& verifierCurve) {
+            for (uint32_t slice = 0; slice < numSlices_; slice++) {
+                if (!SecuredInitialRound::verifySlice(senderID, slot, slice, rValues[slice], slices[slice],
+                        commitments_[memberIndex][slot][nodeIndex_][slice], verifierCurve))
+                    return false;
             }
-            return 0;
+            return true;
         });
-        futures_.push_back(std::move(future));
     }
 
-    // check if an invalid commitment has been detected
-    for (auto &f : futures_)
-        if (f.get() < 0)
+    for (uint32_t slice = 0; slice < numSlices_; slice++) {
+        // verify that the corresponding commitment is valid, otherwise blame the sender
+        if (!delayedVerification_ && !verifier_ &&
+            !SecuredInitialRound::verifySlice(senderID, slot, slice, rValues[slice], slices[slice],
+                                              commitments_[memberIndex][slot][nodeIndex_][slice], threadCurve))
             return -1;
 
-    uint32_t currentSlot = 0;
-    std::list<std::thread> threads_;
-    for (uint32_t t = 0; t < DCNetwork_.numThreads(); t++) {
+        std::lock_guard<std::mutex> lock(threadMutex);
+        R[slot][slice] += rValues[slice];
+        S[slot][slice] += slices[slice];
+    }
 
-        std::thread sharingThread([&]() {
-            CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP> threadCurve;
-            threadCurve.Initialize(CryptoPP::ASN1::secp256k1());
+    if(delayedVerification_) {
+        std::lock_guard<std::mutex> lock(threadMutex);
+        rs_[memberIndex][slot] = std::move(sharingMessage.body());
+    }
+    return 0;
+}
 
-            for (;;) {
-                uint32_t slot;
-                {
-                    std::lock_guard<std::mutex> lock(threadMutex);
-                    if(currentSlot < 2*k_) {
-                        slot = currentSlot;
-                        currentSlot++;
-                    } else {
-                        break;
-                    }
-                }
-                std::vector<uint8_t> broadcastSlot(2 + 64 * numSlices_);
-                broadcastSlot[0] = (slot & 0xFF00) >> 8;
-                broadcastSlot[1] = (slot & 0x00FF);
+void SecuredInitialRound::broadcastAddedShares(uint32_t slot,
+                                               CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve) {
+    std::vector<uint8_t> broadcastSlot(2 + 64 * numSlices_);
+    broadcastSlot[0] = (slot & 0xFF00) >> 8;
+    broadcastSlot[1] = (slot & 0x00FF);
 
-                for (uint32_t slice = 0, offset = 2; slice < numSlices_; slice++, offset += 64) {
-                    S[slot][slice] = S[slot][slice].Modulo(threadCurve.GetGroupOrder());
-                    R[slot][slice] = R[slot][slice].Modulo(threadCurve.GetGroupOrder());
+    for (uint32_t slice = 0, offset = 2; slice < numSlices_; slice++, offset += 64) {
+        S[slot][slice] = S[slot][slice].Modulo(threadCurve.GetGroupOrder());
+        R[slot][slice] = R[slot][slice].Modulo(threadCurve.GetGroupOrder());
 
-                    R[slot][slice].Encode(&broadcastSlot[offset], 32);
-                    S[slot][slice].Encode(&broadcastSlot[offset] + 32, 32);
-                }
+        R[slot][slice].Encode(&broadcastSlot[offset], 32);
+        S[slot][slice].Encode(&broadcastSlot[offset] + 32, 32);
+    }
 
-                auto position = DCNetwork_.members().find(DCNetwork_.nodeID());
-                for (uint32_t member = 0; member < k_ - 1; member++) {
-                    position++;
-                    if (position == DCNetwork_.members().end())
-                        position = DCNetwork_.members().begin();
+    for (uint32_t member = 1; member < k_; member++) {
+        uint32_t memberIndex = (nodeIndex_ + member) % k_;
 
-                    OutgoingMessage rsBroadcast(position->second.connectionID(), InitialRoundSecondSharing,
-                                                DCNetwork_.nodeID(),
-                                                broadcastSlot);
-                    DCNetwork_.outbox().push(std::move(rsBroadcast));
-                }
-            }
-        });
-        threads_.push_back(std::move(sharingThread));
+        OutgoingMessage rsBroadcast(members_->connectionID(memberIndex), InitialRoundSecondSharing,
+                                    DCNetwork_.nodeID(),
+                                    broadcastSlot);
+        DCNetwork_.send(std::move(rsBroadcast), epoch_);
     }
-    for(auto& t : threads_)
-        t.join();
-
-    return 0;
 }
 
 std::vector<std::vector<uint8_t>> SecuredInitialRound::resultComputation() {
-    if(delayedVerification_) {
-        RS_.reserve(k_-1);
-        for (auto member = DCNetwork_.members().begin(); member != DCNetwork_.members().end(); member++) {
-            if (member->first != DCNetwork_.nodeID()) {
-                std::vector<std::vector<std::pair<CryptoPP::Integer, CryptoPP::Integer>>> rsMatrix(2*k_);
-                for(uint32_t slot = 0; slot < 2*k_; slot++)
-                    rsMatrix[slot].reserve(numSlices_);
-                RS_.insert(std::pair(member->second.nodeID(), std::move(rsMatrix)));
-            }
-        }
-    }
+    if(delayedVerification_)
+        RS_.assign(k_, std::vector<std::vector<uint8_t>>(2 * k_));
     // collect the added shares from the other k-1 members and validate them by adding the corresponding commitments
     std::list<std::future<int>> futures_;
     std::mutex threadMutex;
     uint32_t remainingShares = 2 * k_ * (k_ - 1);
+    double auditRate = delayedVerification_ ? DCNetwork_.auditRate() : 0;
     for (uint32_t t = 0; t < DCNetwork_.numThreads(); t++) {
         std::future<int> future = std::async(std::launch::async, [&]() {
             CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP> threadCurve;
             threadCurve.Initialize(CryptoPP::ASN1::secp256k1());
+            CryptoPP::AutoSeededRandomPool threadPRNG;
 
             for (;;) {
                 {
@@ -620,49 +786,76 @@ std::vector<std::vector<uint8_t>> SecuredInitialRound::resultComputation() {
                         return 0;
                 }
 
-                auto rsBroadcast = DCNetwork_.inbox().pop();
+                auto rsBroadcast = DCNetwork_.inbox(epoch_).pop();
 
                 if (rsBroadcast.msgType() == InitialRoundSecondSharing) {
-                    uint32_t memberIndex = std::distance(DCNetwork_.members().begin(),
-                                                         DCNetwork_.members().find(rsBroadcast.senderID()));
+                    int senderIndex = members_->index(rsBroadcast.senderID());
+                    if (senderIndex < 0) {
+                        // drop the shares of nodes outside of the group
+                        std::lock_guard<std::mutex> lock(threadMutex);
+                        remainingShares++;
+                        continue;
+                    }
+                    uint32_t memberIndex = senderIndex;
 
+                    uint32_t senderID = rsBroadcast.senderID();
                     uint32_t slot = (rsBroadcast.body()[0] << 8) | rsBroadcast.body()[1];
+
+                    // extract and decode the random values and the slices of the added shares
+                    std::vector<CryptoPP::Integer> rValues;
+                    std::vector<CryptoPP::Integer> slices;
+                    rValues.reserve(numSlices_);
+                    slices.reserve(numSlices_);
                     for (uint32_t slice = 0, offset = 2; slice < numSlices_; slice++, offset += 64) {
-                        // extract and decode the random values and the slice of the share
-                        CryptoPP::Integer R_(&rsBroadcast.body()[offset], 32);
-                        CryptoPP::Integer S_(&rsBroadcast.body()[offset + 32], 32);
+                        rValues.push_back(CryptoPP::Integer(&rsBroadcast.body()[offset], 32));
+                        slices.push_back(CryptoPP::Integer(&rsBroadcast.body()[offset + 32], 32));
+                    }
 
-                        if(delayedVerification_) {
-                            RS_[rsBroadcast.senderID()][slot].push_back(std::pair(R_,S_));
-                        } else {
-                            // validate r and s
-                            CryptoPP::ECPPoint addedCommitments;
-                            for (auto &c : commitments_)
-                                addedCommitments = threadCurve.GetCurve().Add(addedCommitments,
-                                                                              c.second[slot][memberIndex][slice]);
-
-                            CryptoPP::ECPPoint rG = threadCurve.GetCurve().Multiply(R_, G);
-                            CryptoPP::ECPPoint sH = threadCurve.GetCurve().Multiply(S_, H);
-                            CryptoPP::ECPPoint commitment = threadCurve.GetCurve().Add(rG, sH);
-
-                            if ((commitment.x != addedCommitments.x) || (commitment.y != addedCommitments.y)) {
-                                // broadcast a blame message which contains the invalid share along with the corresponding r values
-                                std::cout << "Invalid commitment detected" << std::endl;
-                                SecuredInitialRound::injectBlameMessage(rsBroadcast.senderID(), slot, slice, R_, S_);
-                                return -1;
-                            }
+                    // the added shares have to match the sum of the commitments of all members
+                    if (verifier_) {
+                        verifier_->submit([this, senderID, memberIndex, slot, rValues, slices](
+                                CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& verifierCurve) {
+                            return SecuredInitialRound::verifyAddedShares(senderID, memberIndex, slot, rValues,
+                                                                          slices, verifierCurve);
+                        });
+                    }
+
+                    if (auditRate > 0) {
+                        int numAudited = SecuredInitialRound::auditShare(senderID, slot, rValues, slices, auditRate,
+                                [&](uint32_t slice) {
+                                    return SecuredInitialRound::addedCommitment(slot, memberIndex, slice, threadCurve);
+                                }, threadCurve, threadPRNG);
+
+                        std::lock_guard<std::mutex> lock(threadMutex);
+                        if (numAudited < 0) {
+                            remainingShares = 0;
+                            return -1;
                         }
+                        auditedSlices_ += numAudited;
+                    }
+
+                    if (!delayedVerification_ && !verifier_ &&
+                        !SecuredInitialRound::verifyAddedShares(senderID, memberIndex, slot, rValues, slices,
+                                                                threadCurve)) {
                         std::lock_guard<std::mutex> lock(threadMutex);
-                        R[slot][slice] += R_;
-                        S[slot][slice] += S_;
+                        remainingShares = 0;
+                        return -1;
+                    }
+
+                    std::lock_guard<std::mutex> lock(threadMutex);
+                    for (uint32_t slice = 0; slice < numSlices_; slice++) {
+                        R[slot][slice] += rValues[slice];
+                        S[slot][slice] += slices[slice];
                     }
 
+                    if (delayedVerification_)
+                        RS_[memberIndex][slot] = std::move(rsBroadcast.body());
                 } else if (rsBroadcast.msgType() == InvalidShare) {
                     SecuredInitialRound::handleBlameMessage(rsBroadcast);
                     std::cout << "Blame message received" << std::endl;
                     return -1;
                 } else {
-                    DCNetwork_.inbox().push(rsBroadcast);
+                    DCNetwork_.inbox(epoch_).push(rsBroadcast);
                     std::this_thread::sleep_for(std::chrono::milliseconds(5));
                     std::lock_guard<std::mutex> lock(threadMutex);
                     remainingShares++;
@@ -678,22 +871,23 @@ std::vector<std::vector<uint8_t>> SecuredInitialRound::resultComputation() {
             return std::vector<std::vector<uint8_t>>();
 
 
+    // the round is finished only after all received shares have been verified
+    if (verifier_ && !verifier_->wait())
+        return std::vector<std::vector<uint8_t>>();
+
     // notify the other nodes that the execution was successful
-    auto position = DCNetwork_.members().find(DCNetwork_.nodeID());
-    for (uint32_t member = 0; member < k_ - 1; member++) {
-        position++;
-        if (position == DCNetwork_.members().end())
-            position = DCNetwork_.members().begin();
+    for (uint32_t member = 1; member < k_; member++) {
+        uint32_t memberIndex = (nodeIndex_ + member) % k_;
 
-        OutgoingMessage finishedBroadcast(position->second.connectionID(), InitialRoundFinished,
+        OutgoingMessage finishedBroadcast(members_->connectionID(memberIndex), InitialRoundFinished,
                                           DCNetwork_.nodeID());
-        DCNetwork_.outbox().push(std::move(finishedBroadcast));
+        DCNetwork_.send(std::move(finishedBroadcast), epoch_);
     }
 
     // wait for the remaining nodes to finish the second sharing phase and catch potential blame messages
     uint32_t remainingNodes = k_-1;
     while(remainingNodes > 0) {
-        auto message = DCNetwork_.inbox().pop();
+        auto message = DCNetwork_.inbox(epoch_).pop();
         if(message.msgType() == InitialRoundFinished) {
             remainingNodes--;
         } else if(message.msgType() == InvalidShare){
@@ -701,7 +895,7 @@ std::vector<std::vector<uint8_t>> SecuredInitialRound::resultComputation() {
             std::cout << "Blame message received" << std::endl;
             return std::vector<std::vector<uint8_t>>();
         } else {
-            DCNetwork_.inbox().push(message);
+            DCNetwork_.inbox(epoch_).push(message);
             std::this_thread::sleep_for(std::chrono::milliseconds(5));
         }
     }
@@ -725,10 +919,11 @@ std::vector<std::vector<uint8_t>> SecuredInitialRound::resultComputation() {
                         break;
                     }
                 }
-                finalMessageSlots[slot].resize(8 + 33 * k_);
+                size_t slotSize = DCNetwork_.reservationSize();
+                finalMessageSlots[slot].resize(slotSize);
                 for (uint32_t slice = 0; slice < numSlices_; slice++) {
                     S[slot][slice] = S[slot][slice].Modulo(curve_.GetGroupOrder());
-                    size_t sliceSize = (((8 + 33 * k_) - 31 * slice > 31) ? 31 : (8 + 33 * k_) - 31 * slice);
+                    size_t sliceSize = ((slotSize - 31 * slice > 31) ? 31 : slotSize - 31 * slice);
                     S[slot][slice].Encode(&finalMessageSlots[slot][31 * slice], sliceSize);
                 }
             }
@@ -742,74 +937,216 @@ std::vector<std::vector<uint8_t>> SecuredInitialRound::resultComputation() {
     return finalMessageSlots;
 }
 
-void SecuredInitialRound::injectBlameMessage(uint32_t suspectID, uint32_t slot, uint32_t slice, CryptoPP::Integer &r,
-                                             CryptoPP::Integer &s) {
-    std::vector<uint8_t> messageBody(76);
-    // set the suspect's ID
-    messageBody[0] = (suspectID & 0xFF000000) >> 24;
-    messageBody[1] = (suspectID & 0x00FF0000) >> 16;
-    messageBody[2] = (suspectID & 0x0000FF00) >> 8;
-    messageBody[3] = (suspectID & 0x000000FF);
-
-    // set the index of the slot
-    messageBody[4] = (slot & 0xFF000000) >> 24;
-    messageBody[5] = (slot & 0x00FF0000) >> 16;
-    messageBody[6] = (slot & 0x0000FF00) >> 8;
-    messageBody[7] = (slot & 0x000000FF);
-
-    // set the index of the slice
-    messageBody[8] = (slice & 0xFF000000) >> 24;
-    messageBody[9] = (slice & 0x00FF0000) >> 16;
-    messageBody[10] = (slice & 0x0000FF00) >> 8;
-    messageBody[11] = (slice & 0x000000FF);
-
-    // store the r and s value
-    r.Encode(&messageBody[12], 32);
-    s.Encode(&messageBody[44], 32);
-
-    for (auto &member : DCNetwork_.members()) {
-        if (member.second.connectionID() != SELF) {
-            OutgoingMessage blameMessage(member.second.connectionID(), InvalidShare, DCNetwork_.nodeID(), messageBody);
-            DCNetwork_.outbox().push(std::move(blameMessage));
-        }
+bool SecuredInitialRound::verifySlice(uint32_t senderID, uint32_t slot, uint32_t slice, const CryptoPP::Integer& r,
+                                      const CryptoPP::Integer& s, const CryptoPP::ECPPoint& commitment,
+                                      CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve) {
+    if (SpotCheck::opens(threadCurve, commitment, r, s))
+        return true;
+
+    std::cout << "Invalid commitment detected" << std::endl;
+    SecuredInitialRound::injectBlameMessage(senderID, slot, slice, r, s);
+    return false;
+}
+
+bool SecuredInitialRound::verifyAddedShares(uint32_t senderID, uint32_t memberIndex, uint32_t slot,
+                                            const std::vector<CryptoPP::Integer>& rValues,
+                                            const std::vector<CryptoPP::Integer>& slices,
+                                            CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve) {
+    for (uint32_t slice = 0; slice < slices.size(); slice++) {
+        if (!SecuredInitialRound::verifySlice(senderID, slot, slice, rValues[slice], slices[slice],
+                SecuredInitialRound::addedCommitment(slot, memberIndex, slice, threadCurve), threadCurve))
+            return false;
     }
+    return true;
 }
 
-void SecuredInitialRound::handleBlameMessage(ReceivedMessage &blameMessage) {
-    std::vector<uint8_t> &body = blameMessage.body();
-    // check which node is addressed by the blame message
-    uint32_t suspectID = (body[0] << 24) | (body[1] << 16) | (body[2] << 8) | body[3];
+int SecuredInitialRound::auditShare(uint32_t senderID, uint32_t slot, const std::vector<CryptoPP::Integer>& rValues,
+                                    const std::vector<CryptoPP::Integer>& slices, double auditRate,
+                                    const std::function<CryptoPP::ECPPoint(uint32_t)>& commitment,
+                                    CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve,
+                                    CryptoPP::RandomNumberGenerator& threadPRNG) {
+    size_t numAudited;
+    int invalid = SpotCheck::audit(threadCurve, threadPRNG, auditRate, rValues, slices, commitment, numAudited);
+    if (invalid > -1) {
+        std::cout << "Invalid commitment detected" << std::endl;
+        SecuredInitialRound::injectBlameMessage(senderID, slot, invalid, rValues[invalid], slices[invalid]);
+        return -1;
+    }
+    return numAudited;
+}
 
-    // extract the index of the slot
-    uint32_t slot = (body[4] << 24) | (body[5] << 16) | (body[6] << 8) | body[7];
+CryptoPP::ECPPoint SecuredInitialRound::addedCommitment(uint32_t slot, uint32_t share, uint32_t slice,
+                                                        CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve) {
+    CryptoPP::ECPPoint addedCommitments;
+    for (uint32_t memberIndex = 0; memberIndex < k_; memberIndex++)
+        addedCommitments = threadCurve.GetCurve().Add(addedCommitments,
+                SecuredInitialRound::receivedCommitment(memberIndex, slot, share, slice, threadCurve));
+    return addedCommitments;
+}
 
-    // extract the index of the corrupted slice
-    uint32_t slice = (body[8] << 24) | (body[9] << 16) | (body[10] << 8) | body[11];
+void SecuredInitialRound::injectBlameMessage(uint32_t suspectID, uint32_t slot, uint32_t slice,
+                                             const CryptoPP::Integer& r, const CryptoPP::Integer& s) {
+    BlameMessage::broadcast(DCNetwork_, epoch_, suspectID, BlameMessage::encode(suspectID, slot, slice, r, {s}));
+}
 
-    // extract the the corrupted slice
-    CryptoPP::Integer r(&body[12], 32);
-    CryptoPP::Integer s(&body[44], 32);
+std::unique_ptr<DCState> SecuredInitialRound::abortRound() {
+    // the members which received different blame messages first would otherwise convict different members
+    if (DCNetwork_.fastRecovery())
+        BlameMessage::collect(DCNetwork_, epoch_, [this](ReceivedMessage& message) {
+            SecuredInitialRound::handleBlameMessage(message);
+        });
+    return InitState::recover(DCNetwork_, epoch_);
+}
+
+void SecuredInitialRound::handleBlameMessage(ReceivedMessage &blameMessage) {
+    if (DCNetwork_.securityLevel() == Adaptive)
+        DCNetwork_.adaptiveSecurity().escalate(AdaptiveValidated, "blame message received");
 
-    // validate that the slice is actually corrupt
-    CryptoPP::ECPPoint rG = curve_.GetCurve().Multiply(r, G);
-    CryptoPP::ECPPoint sH = curve_.GetCurve().Multiply(s, H);
-    CryptoPP::ECPPoint commitment = curve_.GetCurve().Add(rG, sH);
+    BlameMessage::Accusation accusation;
+    if (BlameMessage::decode(blameMessage.body(), accusation) < 0) {
+        std::cout << "Malformed blame message received" << std::endl;
+        return;
+    }
 
-    uint32_t memberIndex = std::distance(DCNetwork_.members().begin(),
-                                         DCNetwork_.members().find(suspectID));
+    int suspectIndex = members_->index(accusation.suspectID);
+    if (suspectIndex < 0) {
+        std::cout << "Blame message for a non-member received" << std::endl;
+        return;
+    }
+    if ((accusation.slot >= R.size()) || (accusation.slice >= numSlices_)) {
+        std::cout << "Blame message for a non-existent slice received" << std::endl;
+        return;
+    }
 
-    // compare the commitment, generated using the submitted values, with the commitment
+    // validate that the disclosed slice is actually corrupt, i.e. it does not open the commitment
     // which has been broadcasted by the suspect
-    if ((commitment.x != commitments_[suspectID][slot][memberIndex][slice].x)
-        || (commitment.y != commitments_[suspectID][slot][memberIndex][slice].y)) {
+    CryptoPP::ECPPoint suspectCommitment = SecuredInitialRound::receivedCommitment(suspectIndex, accusation.slot,
+            suspectIndex, accusation.slice, curve_);
+
+    if (!SpotCheck::opens(curve_, suspectCommitment, accusation.r, accusation.slices[0])) {
         // if the two commitments do not match, the suspect is removed
-        DCNetwork_.members().erase(suspectID);
+        DCNetwork_.excludeMember(accusation.suspectID);
     } else {
         // if the two commitments match, the sender is removed
-        DCNetwork_.members().erase(blameMessage.senderID());
+        DCNetwork_.excludeMember(blameMessage.senderID());
     }
 }
 
+int SecuredInitialRound::revealCommitments() {
+    // broadcast the encoded commitments, which have been announced by their digests
+    for (uint32_t member = 1; member < k_; member++) {
+        uint32_t memberIndex = (nodeIndex_ + member) % k_;
+
+        for (uint32_t slot = 0; slot < 2 * k_; slot++) {
+            OutgoingMessage commitBroadcast(members_->connectionID(memberIndex), InitialRoundCommitments,
+                                            DCNetwork_.nodeID(), encodedCommitments_[slot]);
+            DCNetwork_.send(std::move(commitBroadcast), epoch_);
+        }
+    }
+
+    uint32_t remainingCommitments = 2 * k_ * (k_ - 1);
+    while (remainingCommitments > 0) {
+        auto commitBroadcast = DCNetwork_.inbox(epoch_).pop();
+
+        if ((commitBroadcast.msgType() == InitialRoundCommitments)
+            && SecuredInitialRound::validSharingMessage(commitBroadcast, curve_.GetCurve().EncodedPointSize(true))) {
+            uint32_t slot = (commitBroadcast.body()[0] << 8) | commitBroadcast.body()[1];
+            uint32_t memberIndex = members_->index(commitBroadcast.senderID());
+
+            // the revealed commitments have to match the announced digest
+            std::array<uint8_t, 32> digest = utils::sha256Digest(commitBroadcast.body());
+            if (digest != commitmentDigests_[memberIndex][slot]) {
+                std::cout << "Revealed commitments do not match the digest" << std::endl;
+                if (DCNetwork_.securityLevel() == Adaptive)
+                    DCNetwork_.adaptiveSecurity().escalate(AdaptiveValidated, "revealed commitments do not match");
+                DCNetwork_.excludeMember(commitBroadcast.senderID());
+                return -1;
+            }
+
+            // the commitments are decoded only if they are required
+            rawCommitments_[memberIndex][slot] = std::move(commitBroadcast.body());
+            remainingCommitments--;
+        } else if (commitBroadcast.msgType() != InitialRoundCommitments) {
+            DCNetwork_.inbox(epoch_).push(commitBroadcast);
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+    return 0;
+}
+
+void SecuredInitialRound::decodeCommitments() {
+    size_t encodedPointSize = curve_.GetCurve().EncodedPointSize(true);
+
+    // collect the encoded commitment matrices
+    std::vector<std::pair<uint32_t, uint32_t>> encodings;
+    for (uint32_t memberIndex = 0; memberIndex < rawCommitments_.size(); memberIndex++)
+        for (uint32_t slot = 0; slot < rawCommitments_[memberIndex].size(); slot++)
+            if (rawCommitments_[memberIndex][slot].size() > 0)
+                encodings.push_back(std::pair(memberIndex, slot));
+
+    std::mutex threadMutex;
+    std::list<std::thread> threads_;
+    uint32_t currentEncoding = 0;
+    for (uint32_t t = 0; t < DCNetwork_.numThreads(); t++) {
+        std::thread decodingThread([&]() {
+            CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP> threadCurve;
+            threadCurve.Initialize(CryptoPP::ASN1::secp256k1());
+
+            for (;;) {
+                uint32_t index;
+                {
+                    std::lock_guard<std::mutex> lock(threadMutex);
+                    if (currentEncoding < encodings.size()) {
+                        index = currentEncoding;
+                        currentEncoding++;
+                    } else {
+                        break;
+                    }
+                }
+                uint32_t memberIndex = encodings[index].first;
+                uint32_t slot = encodings[index].second;
+                std::vector<uint8_t> &encoding = rawCommitments_[memberIndex][slot];
+
+                std::vector<std::vector<CryptoPP::ECPPoint>> commitmentMatrix(k_);
+                uint32_t offset = 2;
+                for (uint32_t share = 0; share < k_; share++) {
+                    commitmentMatrix[share].reserve(numSlices_);
+                    for (uint32_t slice = 0; slice < numSlices_; slice++, offset += encodedPointSize) {
+                        CryptoPP::ECPPoint commitment;
+                        threadCurve.GetCurve().DecodePoint(commitment, &encoding[offset], encodedPointSize);
+
+                        commitmentMatrix[share].push_back(std::move(commitment));
+                    }
+                }
+                std::lock_guard<std::mutex> lock(threadMutex);
+                commitments_[memberIndex][slot] = std::move(commitmentMatrix);
+                encoding.clear();
+            }
+        });
+        threads_.push_back(std::move(decodingThread));
+    }
+
+    for (auto &t : threads_)
+        t.join();
+}
+
+CryptoPP::ECPPoint SecuredInitialRound::receivedCommitment(uint32_t memberIndex, uint32_t slot, uint32_t share, uint32_t slice,
+                                                           CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve) {
+    if (commitments_[memberIndex][slot].size() > 0)
+        return commitments_[memberIndex][slot][share][slice];
+
+    // decode only the requested commitment
+    size_t encodedPointSize = threadCurve.GetCurve().EncodedPointSize(true);
+    size_t offset = 2 + (share * numSlices_ + slice) * encodedPointSize;
+
+    CryptoPP::ECPPoint commitment;
+    if ((memberIndex < rawCommitments_.size())
+        && (rawCommitments_[memberIndex][slot].size() >= offset + encodedPointSize))
+        threadCurve.GetCurve().DecodePoint(commitment, &rawCommitments_[memberIndex][slot][offset], encodedPointSize);
+
+    return commitment;
+}
+
 
 
 
@@ -1,14 +1,20 @@
 #ifndef THREEPP_SECUREDINITIALROUND_H
 #define THREEPP_SECUREDINITIALROUND_H
 
+#include <memory>
 #include <cryptopp/ecpoint.h>
 #include <cryptopp/crc.h>
 #include <cryptopp/osrng.h>
 #include <cryptopp/eccrypto.h>
 
+#include <array>
+#include <functional>
+#include <mutex>
 #include <unordered_map>
 #include "DCState.h"
+#include "MemberTable.h"
 #include "../datastruct/ReceivedMessage.h"
+#include "AsyncVerifier.h"
 
 class SecuredInitialRound : public DCState {
 public:
@@ -25,36 +31,104 @@ private:
 
     int sharingPartTwo();
 
+    // sends the first sharing of a slot to the other members
+    void sendShares(uint32_t slot);
+
+    // checks the sender, the slot and the length of a commitment or sharing message before it is decoded
+    bool validSharingMessage(ReceivedMessage& message, size_t encodedPointSize);
+
+    void storeCommitments(ReceivedMessage& commitBroadcast, CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve,
+                          std::mutex& threadMutex);
+
+    // verifies a received share and adds it to the sums of the slot
+    int accumulateShare(ReceivedMessage& sharingMessage, CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve,
+                        CryptoPP::RandomNumberGenerator& threadPRNG, std::mutex& threadMutex);
+
+    // broadcasts the added shares of a slot (second sharing)
+    void broadcastAddedShares(uint32_t slot, CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve);
+
     std::vector<std::vector<uint8_t>> resultComputation();
 
-    void injectBlameMessage(uint32_t suspectID, uint32_t slot, uint32_t slice, CryptoPP::Integer& r, CryptoPP::Integer& s);
+    // verifies a slice against its commitment and blames the sender if it does not match
+    bool verifySlice(uint32_t senderID, uint32_t slot, uint32_t slice, const CryptoPP::Integer& r,
+                     const CryptoPP::Integer& s, const CryptoPP::ECPPoint& commitment,
+                     CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve);
+
+    // verifies the added shares of a member against the sum of the commitments of all members
+    bool verifyAddedShares(uint32_t senderID, uint32_t memberIndex, uint32_t slot,
+                           const std::vector<CryptoPP::Integer>& rValues, const std::vector<CryptoPP::Integer>& slices,
+                           CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve);
+
+    // spot checks a share in the delayed verification mode, commitment returns the commitment of a slice,
+    // returns the number of audited slices or -1 if the sender has been blamed
+    int auditShare(uint32_t senderID, uint32_t slot, const std::vector<CryptoPP::Integer>& rValues,
+                   const std::vector<CryptoPP::Integer>& slices, double auditRate,
+                   const std::function<CryptoPP::ECPPoint(uint32_t)>& commitment,
+                   CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve,
+                   CryptoPP::RandomNumberGenerator& threadPRNG);
+
+    // sum of the commitments of all members to a slice of the given share
+    CryptoPP::ECPPoint addedCommitment(uint32_t slot, uint32_t share, uint32_t slice,
+                                       CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve);
+
+    void injectBlameMessage(uint32_t suspectID, uint32_t slot, uint32_t slice, const CryptoPP::Integer& r,
+                            const CryptoPP::Integer& s);
+
+    // transition to the init state after a blame message,
+    // in the fast recovery mode the remaining blame messages of the epoch are validated first
+    std::unique_ptr<DCState> abortRound();
 
     void handleBlameMessage(ReceivedMessage& blameMessage);
 
+    // exchanges the full commitments, which have been announced by their digests, in case of a dispute
+    int revealCommitments();
+
+    // decodes the commitments which have been kept in their wire encoding
+    void decodeCommitments();
+
+    // returns a received commitment, which is decoded from its wire encoding if necessary
+    CryptoPP::ECPPoint receivedCommitment(uint32_t memberIndex, uint32_t slot, uint32_t share, uint32_t slice,
+                                          CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& threadCurve);
+
     DCNetwork& DCNetwork_;
 
+    // snapshot of the ordered member list at the start of the round
+    std::shared_ptr<const MemberTable> members_;
+
     // DCNetwork size
     uint32_t k_;
 
+    // the final round of the same epoch shares the inbox of this round in the pipelined mode
+    uint64_t epoch_;
+
     uint32_t numSlices_;
 
-    int slotIndex_;
+    // positions of the reserved slots in the order of the submitted messages
+    std::vector<uint32_t> reservedSlots_;
 
     // the position in of the own nodeID in the ordered member list
     size_t nodeIndex_;
 
-    std::vector<CryptoPP::Integer> seedPrivateKeys_;
+    // private keys of the ephemeral seeds of each reservation
+    std::vector<std::vector<CryptoPP::Integer>> seedPrivateKeys_;
 
     std::vector<std::vector<std::vector<CryptoPP::Integer>>> shares_;
 
+    // seeds of the shares sent to the other members in the seeded mode
+    std::vector<std::vector<std::array<uint8_t, 32>>> shareSeeds_;
+
     std::vector<std::vector<std::vector<CryptoPP::Integer>>> rValues_;
 
-    // initial commitments stored with the corresponding senderID
-    std::unordered_map<uint32_t, std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>>> commitments_;
+    // initial commitments indexed by the position of the sender in the member list
+    std::vector<std::vector<std::vector<std::vector<CryptoPP::ECPPoint>>>> commitments_;
+
+    // wire encodings of the received commitments in the delayed verification mode,
+    // one buffer per member and slot, decoded only if a dispute requires them
+    std::vector<std::vector<std::vector<uint8_t>>> rawCommitments_;
 
-    // share and rvalue storage, required for delayed commitment validation
-    std::unordered_map<uint32_t, std::vector<std::vector<std::pair<CryptoPP::Integer, CryptoPP::Integer>>>> rs_;
-    std::unordered_map<uint32_t, std::vector<std::vector<std::pair<CryptoPP::Integer, CryptoPP::Integer>>>> RS_;
+    // wire encodings of the shares and rvalues per member and slot, required for delayed commitment validation
+    std::vector<std::vector<std::vector<uint8_t>>> rs_;
+    std::vector<std::vector<std::vector<uint8_t>>> RS_;
 
     // sum of all shares
     std::vector<std::vector<CryptoPP::Integer>> S;
@@ -69,6 +143,22 @@ private:
     CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP> curve_;
 
     bool delayedVerification_;
+
+    // number of slices verified by the spot checks in this round
+    uint64_t auditedSlices_;
+
+    // determines whether only the digests of the encoded commitments are broadcasted
+    bool optimistic_;
+
+    // own encoded commitments, kept until the round is finished
+    std::vector<std::vector<uint8_t>> encodedCommitments_;
+
+    // digests of the encoded commitments indexed by the position of the sender in the member list
+    std::vector<std::vector<std::array<uint8_t, 32>>> commitmentDigests_;
+
+    // verifies the received shares alongside the sharing in the speculative mode,
+    // declared last so that the workers are stopped before the data they access is destroyed
+    std::unique_ptr<AsyncVerifier> verifier_;
 };
 
 
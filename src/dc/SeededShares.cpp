@@ -0,0 +1,39 @@
+#include <cryptopp/modes.h>
+#include <cryptopp/aes.h>
+#include <cryptopp/sha.h>
+#include "SeededShares.h"
+
+std::array<uint8_t, 32> SeededShares::shareSeed(const std::array<uint8_t, 32>& slotSeed, uint32_t share) {
+    std::array<uint8_t, 4> encodedShare;
+    encodedShare[0] = (share & 0xFF000000) >> 24;
+    encodedShare[1] = (share & 0x00FF0000) >> 16;
+    encodedShare[2] = (share & 0x0000FF00) >> 8;
+    encodedShare[3] = (share & 0x000000FF);
+
+    std::array<uint8_t, 32> seed;
+    CryptoPP::SHA256 sha256;
+    sha256.Update(slotSeed.data(), slotSeed.size());
+    sha256.Update(encodedShare.data(), encodedShare.size());
+    sha256.Final(seed.data());
+    return seed;
+}
+
+void SeededShares::expand(const std::array<uint8_t, 32>& seed, size_t numSlices, const CryptoPP::Integer& maxExponent,
+                          std::vector<CryptoPP::Integer>& rValues, std::vector<CryptoPP::Integer>* slices) {
+    CryptoPP::OFB_Mode<CryptoPP::AES>::Encryption DRNG;
+    DRNG.SetKeyWithIV(seed.data(), 16, seed.data() + 16, 16);
+
+    // the blinding factors are expanded first, so they can be recomputed without the slices
+    rValues.clear();
+    rValues.reserve(numSlices);
+    for (uint32_t slice = 0; slice < numSlices; slice++)
+        rValues.push_back(CryptoPP::Integer(DRNG, CryptoPP::Integer::One(), maxExponent));
+
+    if (slices == nullptr)
+        return;
+
+    slices->clear();
+    slices->reserve(numSlices);
+    for (uint32_t slice = 0; slice < numSlices; slice++)
+        slices->push_back(CryptoPP::Integer(DRNG, CryptoPP::Integer::One(), maxExponent));
+}
@@ -0,0 +1,20 @@
+#ifndef THREEPP_SEEDEDSHARES_H
+#define THREEPP_SEEDEDSHARES_H
+
+#include <array>
+#include <vector>
+#include <cryptopp/integer.h>
+
+// In the seeded mode a share and its blinding factors are expanded from a 32 byte seed,
+// which is sent in the first sharing instead of the (r, s) pairs of all slices.
+namespace SeededShares {
+    // seed of a share, derived from the seed of a slot in the final round
+    std::array<uint8_t, 32> shareSeed(const std::array<uint8_t, 32>& slotSeed, uint32_t share);
+
+    // expands the blinding factors and, if requested, the slices of a share
+    void expand(const std::array<uint8_t, 32>& seed, size_t numSlices, const CryptoPP::Integer& maxExponent,
+                std::vector<CryptoPP::Integer>& rValues, std::vector<CryptoPP::Integer>* slices = nullptr);
+};
+
+
+#endif //THREEPP_SEEDEDSHARES_H
@@ -0,0 +1,88 @@
+#include "SpotCheck.h"
+#include "DCNetwork.h"
+
+std::vector<uint32_t> SpotCheck::sample(CryptoPP::RandomNumberGenerator& rng, size_t numSlices, double auditRate) {
+    std::vector<uint32_t> audited;
+    if (auditRate <= 0)
+        return audited;
+
+    // a slice is audited if a uniformly drawn 32 bit word is below the threshold
+    uint64_t threshold = auditRate >= 1 ? 0x100000000 : static_cast<uint64_t>(auditRate * 0x100000000);
+    for (uint32_t slice = 0; slice < numSlices; slice++)
+        if (rng.GenerateWord32() < threshold)
+            audited.push_back(slice);
+
+    return audited;
+}
+
+int SpotCheck::verify(CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& curve, CryptoPP::RandomNumberGenerator& rng,
+                      const std::vector<CryptoPP::Integer>& rValues, const std::vector<CryptoPP::Integer>& slices,
+                      const std::vector<CryptoPP::ECPPoint>& commitments) {
+    if (commitments.size() == 0)
+        return -1;
+
+    // without the random weights the errors of two slices could cancel each other out
+    CryptoPP::Integer r;
+    CryptoPP::Integer s;
+    CryptoPP::ECPPoint C;
+    std::vector<uint8_t> weight(WEIGHT_SIZE);
+    for (uint32_t i = 0; i < commitments.size(); i++) {
+        rng.GenerateBlock(weight.data(), weight.size());
+        // the highest bit is set to avoid a zero weight
+        weight[0] |= 0x80;
+        CryptoPP::Integer w(weight.data(), weight.size());
+
+        r += w * rValues[i];
+        s += w * slices[i];
+        C = curve.GetCurve().Add(C, curve.GetCurve().ScalarMultiply(commitments[i], w));
+    }
+    r = r.Modulo(curve.GetGroupOrder());
+    s = s.Modulo(curve.GetGroupOrder());
+
+    if (opens(curve, C, r, s))
+        return -1;
+
+    // locate the invalid slice
+    for (uint32_t i = 0; i < commitments.size(); i++) {
+        if (!opens(curve, commitments[i], rValues[i], slices[i]))
+            return i;
+    }
+    // inconclusive, no slice is blamed
+    return -1;
+}
+
+int SpotCheck::audit(CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& curve, CryptoPP::RandomNumberGenerator& rng,
+                     double auditRate, const std::vector<CryptoPP::Integer>& rValues,
+                     const std::vector<CryptoPP::Integer>& slices,
+                     const std::function<CryptoPP::ECPPoint(uint32_t slice)>& commitment, size_t& numAudited) {
+    std::vector<uint32_t> audited = sample(rng, slices.size(), auditRate);
+    numAudited = audited.size();
+
+    std::vector<CryptoPP::Integer> sampledRValues;
+    std::vector<CryptoPP::Integer> sampledSlices;
+    std::vector<CryptoPP::ECPPoint> sampledCommitments;
+    sampledRValues.reserve(numAudited);
+    sampledSlices.reserve(numAudited);
+    sampledCommitments.reserve(numAudited);
+    for (uint32_t slice : audited) {
+        sampledRValues.push_back(rValues[slice]);
+        sampledSlices.push_back(slices[slice]);
+        sampledCommitments.push_back(commitment(slice));
+    }
+
+    int invalid = verify(curve, rng, sampledRValues, sampledSlices, sampledCommitments);
+    return invalid > -1 ? audited[invalid] : -1;
+}
+
+CryptoPP::ECPPoint SpotCheck::commit(const CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& curve,
+                                     const CryptoPP::Integer& r, const CryptoPP::Integer& s) {
+    CryptoPP::ECPPoint rG = curve.GetCurve().ScalarMultiply(G, r);
+    CryptoPP::ECPPoint sH = curve.GetCurve().ScalarMultiply(H, s);
+    return curve.GetCurve().Add(rG, sH);
+}
+
+bool SpotCheck::opens(const CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& curve,
+                      const CryptoPP::ECPPoint& commitment, const CryptoPP::Integer& r, const CryptoPP::Integer& s) {
+    CryptoPP::ECPPoint opened = commit(curve, r, s);
+    return (opened.x == commitment.x) && (opened.y == commitment.y);
+}
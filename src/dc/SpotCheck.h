@@ -0,0 +1,43 @@
+#ifndef THREEPP_SPOTCHECK_H
+#define THREEPP_SPOTCHECK_H
+
+#include <vector>
+#include <functional>
+#include <cryptopp/integer.h>
+#include <cryptopp/ecpoint.h>
+#include <cryptopp/eccrypto.h>
+
+// Probabilistic verification of the received shares in the delayed verification mode.
+// Each slice is audited with a given probability, the audited slices are verified with a single batch check.
+namespace SpotCheck {
+    // selects each slice independently with the given probability
+    std::vector<uint32_t> sample(CryptoPP::RandomNumberGenerator& rng, size_t numSlices, double auditRate);
+
+    // size of the random weights of the batch check in bytes
+    const size_t WEIGHT_SIZE = 8;
+
+    // verifies sum(w*r)*G + sum(w*s)*H = sum(w*C) with random 64 bit weights w and, if the check fails,
+    // each slice separately, returns the position of the first invalid slice
+    // or -1 if all slices are valid or no single slice can be blamed
+    int verify(CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& curve, CryptoPP::RandomNumberGenerator& rng,
+               const std::vector<CryptoPP::Integer>& rValues, const std::vector<CryptoPP::Integer>& slices,
+               const std::vector<CryptoPP::ECPPoint>& commitments);
+
+    // audits a sample of the slices of a share, commitment returns the expected commitment of a slice,
+    // returns the index of an invalid slice or -1 and sets numAudited to the number of audited slices
+    int audit(CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& curve, CryptoPP::RandomNumberGenerator& rng,
+              double auditRate, const std::vector<CryptoPP::Integer>& rValues,
+              const std::vector<CryptoPP::Integer>& slices,
+              const std::function<CryptoPP::ECPPoint(uint32_t slice)>& commitment, size_t& numAudited);
+
+    // computes the commitment r*G + s*H of a single slice
+    CryptoPP::ECPPoint commit(const CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& curve, const CryptoPP::Integer& r,
+                              const CryptoPP::Integer& s);
+
+    // checks whether r and s open the commitment
+    bool opens(const CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& curve, const CryptoPP::ECPPoint& commitment,
+               const CryptoPP::Integer& r, const CryptoPP::Integer& s);
+};
+
+
+#endif //THREEPP_SPOTCHECK_H
@@ -1,4 +1,5 @@
 #include <iomanip>
+#include <algorithm>
 #include "UnsecuredFinalRound.h"
 #include "DCNetwork.h"
 #include "../datastruct/MessageType.h"
@@ -7,11 +8,14 @@
 #include "UnsecuredInitialRound.h"
 #include "../ad/VirtualSource.h"
 
-UnsecuredFinalRound::UnsecuredFinalRound(DCNetwork &DCNet, int slotIndex, std::vector<std::pair<uint16_t, uint16_t>> slots)
-        : DCNetwork_(DCNet), k_(DCNetwork_.k()), slotIndex_(slotIndex), slots_(std::move(slots)) {
+UnsecuredFinalRound::UnsecuredFinalRound(DCNetwork &DCNet, std::vector<int> slotIndices,
+                                         std::vector<std::pair<uint16_t, uint16_t>> slots, uint64_t epoch)
+        : DCNetwork_(DCNet), members_(DCNet.memberTable()), k_(DCNetwork_.k()),
+          slotIndices_(std::move(slotIndices)), slots_(std::move(slots)),
+          epoch_(epoch) {
 
     // determine the index of the own nodeID in the ordered member list
-    nodeIndex_ = std::distance(DCNetwork_.members().begin(), DCNetwork_.members().find(DCNetwork_.nodeID()));
+    nodeIndex_ = members_->index(DCNetwork_.nodeID());
 }
 
 UnsecuredFinalRound::~UnsecuredFinalRound() {}
@@ -27,24 +31,22 @@ std::unique_ptr<DCState> UnsecuredFinalRound::executeTask() {
     runtimes.push_back(elapsed.count());
 
     start = std::chrono::high_resolution_clock::now();
-    // generate and distribute the commitments and shares
-    UnsecuredFinalRound::sharingPartOne();
+    // broadcast the padded slots
+    UnsecuredFinalRound::sharing();
 
     finish = std::chrono::high_resolution_clock::now();
     elapsed = finish - start;
     runtimes.push_back(elapsed.count());
 
     start = std::chrono::high_resolution_clock::now();
-    // collect and validate the shares
-    UnsecuredFinalRound::sharingPartTwo();
+    // collect the padded slots of the other members
+    UnsecuredFinalRound::resultComputation();
 
     finish = std::chrono::high_resolution_clock::now();
     elapsed = finish - start;
     runtimes.push_back(elapsed.count());
 
     start = std::chrono::high_resolution_clock::now();
-    // collect and validate the final shares
-    UnsecuredFinalRound::resultComputation();
 
     // Logging
     if (DCNetwork_.logging()) {
@@ -63,7 +65,8 @@ std::unique_ptr<DCState> UnsecuredFinalRound::executeTask() {
         // round 1
         log[4 * sizeof(double) + 1] = 2;
         //sending
-        log[4 * sizeof(double) + 2] = (slotIndex_ > -1) ? 1 : 0;
+        log[4 * sizeof(double) + 2] = std::any_of(slotIndices_.begin(), slotIndices_.end(),
+                                                  [](int slotIndex) { return slotIndex > -1; }) ? 1 : 0;
         //numThreads
         log[4 * sizeof(double) + 3] = DCNetwork_.numThreads();
 
@@ -90,6 +93,8 @@ std::unique_ptr<DCState> UnsecuredFinalRound::executeTask() {
         bool valid = CRC32_.Verify(slot.data());
         if(!valid) {
             // Switch to the secured version
+            if (DCNetwork_.securityLevel() == Adaptive)
+                DCNetwork_.adaptiveSecurity().escalate(AdaptiveSecured, "invalid CRC in the final round");
             return std::make_unique<SecuredInitialRound>(DCNetwork_);
         }
     }
@@ -109,103 +114,60 @@ std::unique_ptr<DCState> UnsecuredFinalRound::executeTask() {
         }
     }
     std::this_thread::sleep_for(std::chrono::seconds(DCNetwork_.interval()));
+
+    if (DCNetwork_.securityLevel() == Adaptive)
+        DCNetwork_.adaptiveSecurity().cleanRound();
+
     return std::make_unique<UnsecuredInitialRound>(DCNetwork_);
 }
 
 void UnsecuredFinalRound::preparation() {
     size_t numSlots = slots_.size();
 
-    std::vector<uint8_t> submittedMessage;
-    if (slotIndex_ > -1) {
-        submittedMessage = DCNetwork_.submittedMessages().front();
-        DCNetwork_.submittedMessages().pop();
-    }
+    S.resize(numSlots);
+    for (uint32_t slot = 0; slot < numSlots; slot++)
+        S[slot].resize(4 + slots_[slot].first);
 
-    // initialize the slices in the slots of the final share with the slices of the own share
-    S.reserve(numSlots);
+    // place the submitted messages in their slots
+    for (uint32_t i = 0; i < slotIndices_.size(); i++) {
+        if (slotIndices_[i] < 0)
+            continue;
 
-    shares_.resize(numSlots);
+        std::vector<uint8_t>& submittedMessage = DCNetwork_.submittedMessages()[i];
+        std::vector<uint8_t>& messageSlot = S[slotIndices_[i]];
+        // Calculate the CRC
+        CRC32_.Update(submittedMessage.data(), submittedMessage.size());
+        CRC32_.Final(messageSlot.data());
 
-    for (uint32_t slot = 0; slot < numSlots; slot++) {
-        shares_[slot].resize(k_);
-
-        shares_[slot][k_ - 1].resize(4 + slots_[slot].first);
-        if (static_cast<uint32_t>(slotIndex_) == slot) {
-            // Calculate the CRC
-            CRC32_.Update(submittedMessage.data(), submittedMessage.size());
-            CRC32_.Final(shares_[slot][k_ - 1].data());
-
-            std::copy(submittedMessage.begin(), submittedMessage.end(), &shares_[slot][k_ - 1][4]);
-        }
-
-        for (uint32_t share = 0; share < k_ - 1; share++) {
-            shares_[slot][share].resize(4 + slots_[slot].first);
-            PRNG.GenerateBlock(shares_[slot][share].data(), 4 + slots_[slot].first);
-
-            // XOR The value to the final share
-            for (uint32_t p = 0; p < 4 + static_cast<uint32_t>(slots_[slot].first); p++)
-                shares_[slot][k_ - 1][p] ^= shares_[slot][share][p];
-        }
-
-        S.push_back(shares_[slot][nodeIndex_]);
+        std::copy(submittedMessage.begin(), submittedMessage.end(), &messageSlot[4]);
     }
-}
-
-void UnsecuredFinalRound::sharingPartOne() {
-    size_t numSlots = slots_.size();
 
-    auto position = DCNetwork_.members().find(DCNetwork_.nodeID());
-    for (uint32_t member = 0; member < k_ - 1; member++) {
-        position++;
-        if (position == DCNetwork_.members().end())
-            position = DCNetwork_.members().begin();
+    // the messages of failed reservations remain in the queue for the next round
+    for (size_t i = slotIndices_.size(); i-- > 0;) {
+        if (slotIndices_[i] > -1)
+            DCNetwork_.submittedMessages().erase(DCNetwork_.submittedMessages().begin() + i);
+    }
 
-        uint32_t memberIndex = std::distance(DCNetwork_.members().begin(), position);
-        for (uint32_t slot = 0; slot < numSlots; slot++) {
-            std::vector<uint8_t> share(6 + slots_[slot].first);
-            share[0] = (slot & 0xFF00) >> 8;
-            share[1] = (slot & 0x00FF);
-            std::copy(shares_[slot][memberIndex].begin(), shares_[slot][memberIndex].end(), &share[2]);
-            OutgoingMessage sharingMessage(position->second.connectionID(), FinalRoundFirstSharing, DCNetwork_.nodeID(),
-                                           share);
-            DCNetwork_.outbox().push(std::move(sharingMessage));
-        }
+    for (uint32_t slot = 0; slot < numSlots; slot++) {
+        // the pads are expanded locally from the pairwise seeds,
+        // therefore only the padded slots have to be broadcasted
+        DCNetwork_.applyPads(S[slot].data(), S[slot].size(), epoch_, FinalRoundPads, slot);
     }
 }
 
-void UnsecuredFinalRound::sharingPartTwo() {
+void UnsecuredFinalRound::sharing() {
     size_t numSlots = slots_.size();
 
-    // collect the shares from the other k-1 members and validate them using the broadcasted commitments
-    uint32_t remainingShares = numSlots * (k_ - 1);
-    while (remainingShares > 0) {
-        auto sharingMessage = DCNetwork_.inbox().pop();
-
-        if (sharingMessage.msgType() == FinalRoundFirstSharing) {
-            size_t slot = (sharingMessage.body()[0] << 8) | sharingMessage.body()[1];
-            for (uint32_t p = 0; p < 4 + static_cast<uint32_t>(slots_[slot].first); p++)
-                S[slot][p] ^= sharingMessage.body()[p+2];
-
-            remainingShares--;
-        } else {
-            DCNetwork_.inbox().push(sharingMessage);
-            std::this_thread::sleep_for(std::chrono::milliseconds(5));
-        }
-    }
-
-    auto position = DCNetwork_.members().find(DCNetwork_.nodeID());
-    for (uint32_t member = 0; member < k_ - 1; member++) {
-        position++;
-        if (position == DCNetwork_.members().end())
-            position = DCNetwork_.members().begin();
+    for (uint32_t member = 1; member < k_; member++) {
+        uint32_t memberIndex = (nodeIndex_ + member) % k_;
 
         for (uint32_t slot = 0; slot < numSlots; slot++) {
-            std::vector<uint8_t> addedShares(6 + slots_[slot].first);
-            addedShares[0] = (slot & 0xFF00) >> 8;
-            addedShares[1] = (slot & 0x00FF);
-            std::copy(S[slot].begin(), S[slot].end(), &addedShares[2]);
-            OutgoingMessage sharingMessage(position->second.connectionID(), FinalRoundSecondSharing, DCNetwork_.nodeID(),
-                                           addedShares);
+            std::vector<uint8_t> paddedSlot(6 + slots_[slot].first);
+            paddedSlot[0] = (slot & 0xFF00) >> 8;
+            paddedSlot[1] = (slot & 0x00FF);
+            std::copy(S[slot].begin(), S[slot].end(), &paddedSlot[2]);
+            OutgoingMessage sharingMessage(members_->connectionID(memberIndex), FinalRoundSecondSharing, DCNetwork_.nodeID(),
+                                           paddedSlot);
             DCNetwork_.outbox().push(std::move(sharingMessage));
         }
     }
@@ -219,7 +181,7 @@ void UnsecuredFinalRound::resultComputation() {
         auto sharingBroadcast = DCNetwork_.inbox().pop();
 
         if (sharingBroadcast.msgType() == FinalRoundSecondSharing) {
-            size_t slot = (sharingBroadcast.body()[0]) | sharingBroadcast.body()[1];
+            size_t slot = (sharingBroadcast.body()[0] << 8) | sharingBroadcast.body()[1];
 
             for (uint32_t p = 0; p < 4 + static_cast<uint32_t>(slots_[slot].first); p++)
                 S[slot][p] ^= sharingBroadcast.body()[p+2];
@@ -1,13 +1,15 @@
 #ifndef THREEPP_UNSECUREDFINALROUND_H
 #define THREEPP_UNSECUREDFINALROUND_H
 
-#include <cryptopp/osrng.h>
+#include <memory>
 #include <cryptopp/crc.h>
 #include "DCState.h"
+#include "MemberTable.h"
 
 class UnsecuredFinalRound : public DCState {
 public:
-    UnsecuredFinalRound(DCNetwork& DCNet, int slotIndex, std::vector<std::pair<uint16_t, uint16_t>> slots);
+    UnsecuredFinalRound(DCNetwork& DCNet, std::vector<int> slotIndices, std::vector<std::pair<uint16_t, uint16_t>> slots,
+                        uint64_t epoch);
 
     virtual ~UnsecuredFinalRound();
 
@@ -16,33 +18,33 @@ public:
 private:
     void preparation();
 
-    void sharingPartOne();
-
-    void sharingPartTwo();
+    void sharing();
 
     void resultComputation();
 
     DCNetwork& DCNetwork_;
 
+    // snapshot of the ordered member list at the start of the round
+    std::shared_ptr<const MemberTable> members_;
+
     // DCNetwork size
     size_t k_;
 
     // the position in of the own nodeID in the ordered member list
     size_t nodeIndex_;
 
-    // index of the slot in the message vector
-    int slotIndex_;
+    // index of the slot in the message vector for each submitted message, -1 if the reservation failed
+    std::vector<int> slotIndices_;
 
     std::vector<std::pair<uint16_t, uint16_t>> slots_;
 
-    std::vector<std::vector<std::vector<uint8_t>>> shares_;
+    // epoch of the preceding initial round, which identifies the pads of this round
+    uint64_t epoch_;
 
-    // sum of all shares
+    // sum of all padded slots
     std::vector<std::vector<uint8_t>> S;
 
     CryptoPP::CRC32 CRC32_;
-
-    CryptoPP::AutoSeededRandomPool PRNG;
 };
 
 
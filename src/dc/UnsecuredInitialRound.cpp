@@ -1,4 +1,5 @@
 #include <iomanip>
+#include <algorithm>
 #include "UnsecuredInitialRound.h"
 
 #include "DCNetwork.h"
@@ -8,8 +9,9 @@
 #include "UnsecuredFinalRound.h"
 
 
-UnsecuredInitialRound::UnsecuredInitialRound(DCNetwork &DCNet) : DCNetwork_(DCNet), k_(DCNetwork_.k()) {
-    nodeIndex_ = std::distance(DCNetwork_.members().begin(), DCNetwork_.members().find(DCNetwork_.nodeID()));
+UnsecuredInitialRound::UnsecuredInitialRound(DCNetwork &DCNet)
+: DCNetwork_(DCNet), members_(DCNet.memberTable()), k_(DCNetwork_.k()), epoch_(DCNet.nextEpoch()) {
+    nodeIndex_ = members_->index(DCNetwork_.nodeID());
 }
 
 UnsecuredInitialRound::~UnsecuredInitialRound() {}
@@ -19,40 +21,52 @@ std::unique_ptr<DCState> UnsecuredInitialRound::executeTask() {
 
     auto start = std::chrono::high_resolution_clock::now();
     // prepare the shares
-    int slotIndex = UnsecuredInitialRound::preparation();
+    UnsecuredInitialRound::preparation();
 
     auto finish = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> elapsed = finish - start;
     runtimes.push_back(elapsed.count());
 
     start = std::chrono::high_resolution_clock::now();
-    // generate and distribute the commitments and shares
-    UnsecuredInitialRound::sharingPartOne();
+    // broadcast the padded vector
+    UnsecuredInitialRound::sharing();
 
     finish = std::chrono::high_resolution_clock::now();
     elapsed = finish - start;
     runtimes.push_back(elapsed.count());
 
     start = std::chrono::high_resolution_clock::now();
-    // collect and validate the shares
-    UnsecuredInitialRound::sharingPartTwo();
+    // collect the padded vectors of the other members
+    UnsecuredInitialRound::resultComputation();
 
-    // logging
     finish = std::chrono::high_resolution_clock::now();
     elapsed = finish - start;
     runtimes.push_back(elapsed.count());
 
     start = std::chrono::high_resolution_clock::now();
-    // collect and validate the final shares
-    UnsecuredInitialRound::resultComputation();
 
     // prepare round two
     std::vector<std::pair<uint16_t, uint16_t>> slots;
 
     // determine the non-empty slots in the message vector
-    // and calculate the index of the own slot if present
-    int finalSlotIndex = -1;
+    // and calculate the index of each own slot if present
+    std::vector<int> slotIndices(reservedSlots_.size(), -1);
     uint32_t invalidCRCs = 0;
+    // the shared slots are checked against the shared reservations, which the members announce after the slots
+    bool sharedSlots = DCNetwork_.maxSlots() > 1;
+    uint32_t sharedReservations = 0;
+    uint32_t validSharedSlots = 0;
+    uint32_t invalidSharedSlots = 0;
+    if (sharedSlots) {
+        for (uint32_t member = 0; member < k_; member++) {
+            uint8_t announced = S[16 * k_ + member];
+            // a member cannot reserve more shared slots than the others
+            if (announced < DCNetwork_.maxSlots())
+                sharedReservations += announced;
+            else
+                invalidCRCs++;
+        }
+    }
     for (uint32_t slot = 0; slot < 2 * k_; slot++) {
         uint16_t round_identifier = (S[slot * 8 + 4] << 8) | S[slot * 8 + 5];
         uint16_t slotSize = (S[slot * 8 + 6] << 8) | S[slot * 8 + 7];
@@ -63,22 +77,38 @@ std::unique_ptr<DCState> UnsecuredInitialRound::executeTask() {
             bool valid = CRC32_.Verify(&S[slot * 8]);
 
             if (!valid) {
-                invalidCRCs++;
+                // two members may reserve the same shared slot,
+                // which is distinguished from disruption by the announced shared reservations
+                if ((slot < k_) || !sharedSlots)
+                    invalidCRCs++;
+                else
+                    invalidSharedSlots++;
             } else {
-                if(static_cast<uint32_t>(slotIndex) == slot)
-                    finalSlotIndex = slots.size();
+                if (sharedSlots && (slot >= k_))
+                    validSharedSlots++;
+
+                auto reservation = std::find(reservedSlots_.begin(), reservedSlots_.end(), slot);
+                if (reservation != reservedSlots_.end())
+                    slotIndices[reservation - reservedSlots_.begin()] = slots.size();
                 // store the size of the slot and the corresponding round identifier
                 slots.push_back(std::pair(slotSize, round_identifier));
             }
         }
     }
 
+    if (sharedSlots)
+        invalidCRCs += DCNetwork_.disruptedSharedSlots(invalidSharedSlots, validSharedSlots, sharedReservations);
+
     if(invalidCRCs > std::floor(k_/2)) {
         std::cout << "More than k/2 invalid CRCs detected." << std::endl;
         std::cout << "Switching to Proof of Fairness Protocol" << std::endl;
+        if (DCNetwork_.securityLevel() == Adaptive)
+            DCNetwork_.adaptiveSecurity().escalate(AdaptiveSecured, "invalid CRCs in the initial round");
         return std::make_unique<SecuredInitialRound>(DCNetwork_);
     }
 
+    bool sending = std::any_of(slotIndices.begin(), slotIndices.end(), [](int slotIndex) { return slotIndex > -1; });
+
     // Logging
     if (DCNetwork_.logging() && (slots.size() != 0)) {
         auto finish = std::chrono::high_resolution_clock::now();
@@ -96,7 +126,7 @@ std::unique_ptr<DCState> UnsecuredInitialRound::executeTask() {
         // round 1
         log[4 * sizeof(double) + 1] = 1;
         //sending
-        log[4 * sizeof(double) + 2] = (finalSlotIndex > -1) ? 1 : 0;
+        log[4 * sizeof(double) + 2] = sending ? 1 : 0;
         //numThreads
         log[4 * sizeof(double) + 3] = DCNetwork_.numThreads();
 
@@ -104,8 +134,9 @@ std::unique_ptr<DCState> UnsecuredInitialRound::executeTask() {
         DCNetwork_.outbox().push(std::move(logMessage));
     }
 
-    if (finalSlotIndex > -1) {
-        std::cout << "Node " << DCNetwork_.nodeID() << ": sending in slot " << std::dec << finalSlotIndex << std::endl << std::endl;
+    for (int slotIndex : slotIndices) {
+        if (slotIndex > -1)
+            std::cout << "Node " << DCNetwork_.nodeID() << ": sending in slot " << std::dec << slotIndex << std::endl << std::endl;
     }
 
     // if no member wants to send a message, return to the Ready state
@@ -114,27 +145,23 @@ std::unique_ptr<DCState> UnsecuredInitialRound::executeTask() {
         std::this_thread::sleep_for(std::chrono::seconds(1));
         return std::make_unique<UnsecuredInitialRound>(DCNetwork_);
     } else
-        return std::make_unique<UnsecuredFinalRound>(DCNetwork_, finalSlotIndex, std::move(slots));
+        return std::make_unique<UnsecuredFinalRound>(DCNetwork_, std::move(slotIndices), std::move(slots), epoch_);
 }
 
-int UnsecuredInitialRound::preparation() {
-    // check if there is a submitted message and determine it's length,
-    uint16_t l = 0;
-    if (!DCNetwork_.submittedMessages().empty()) {
-        size_t msgSize = DCNetwork_.submittedMessages().front().size();
-        // ensure that the message size does not exceed 2^16 Bytes
-        l = msgSize > USHRT_MAX ? USHRT_MAX : msgSize;
-    }
-
-    size_t msgSize = 16 * k_;
-
-    std::vector<uint8_t> slot(8);
+void UnsecuredInitialRound::preparation() {
+    // the slots are followed by the number of shared reservations of each member if shared slots are used
+    size_t msgSize = 16 * k_ + ((DCNetwork_.maxSlots() > 1) ? k_ : 0);
+    S.resize(msgSize);
 
-    int slotIndex = -1;
-    if (l > 0) {
+    // reserve a slot for each of the first submitted messages
+    reservedSlots_ = DCNetwork_.reserveSlots(PRNG);
+    for (uint32_t i = 0; i < reservedSlots_.size(); i++) {
+        // ensure that the message size does not exceed 2^16 Bytes
+        size_t messageSize = DCNetwork_.submittedMessages()[i].size();
+        uint16_t l = messageSize > USHRT_MAX ? USHRT_MAX : messageSize;
         uint16_t r = PRNG.GenerateWord32(0, USHRT_MAX);
-        slotIndex = nodeIndex_; //PRNG.GenerateWord32(0, 2 * k_ - 1);
 
+        uint8_t* slot = &S[reservedSlots_[i] * 8];
         // set the values in Big Endian format
         slot[4] = (r & 0xFF00) >> 8;
         slot[5] = (r & 0x00FF);
@@ -143,89 +170,38 @@ int UnsecuredInitialRound::preparation() {
 
         // Calculate the CRC
         CRC32_.Update(&slot[4], 4);
-        CRC32_.Final(slot.data());
-    }
-
-    shares_.resize(k_);
-    shares_[k_ - 1].resize(msgSize);
-
-    if (slotIndex > -1)
-        for (uint32_t p = 0; p < 8; p++)
-            shares_[k_ - 1][slotIndex * 8 + p] ^= slot[p];
-
-    // fill the first slices of the first k-1 shares with random values
-    // and subtract the values from the corresponding slices in the k-th share
-    for (uint32_t share = 0; share < k_ - 1; share++) {
-        shares_[share].resize(msgSize);
-        PRNG.GenerateBlock(shares_[share].data(), msgSize);
-
-        // XOR The value to the final slot
-        for (uint32_t p = 0; p < msgSize; p++)
-            shares_[k_ - 1][p] ^= shares_[share][p];
+        CRC32_.Final(slot);
     }
 
-    // store the own share in S
-    S = shares_[nodeIndex_];
+    if (!reservedSlots_.empty() && (DCNetwork_.maxSlots() > 1))
+        S[16 * k_ + nodeIndex_] = reservedSlots_.size() - 1;
 
-    return slotIndex;
+    // the pads are expanded locally from the pairwise seeds,
+    // therefore only the padded vector has to be broadcasted
+    DCNetwork_.applyPads(S.data(), msgSize, epoch_, InitialRoundPads, 0);
 }
 
-void UnsecuredInitialRound::sharingPartOne() {
-    auto position = DCNetwork_.members().find(DCNetwork_.nodeID());
-    for (uint32_t member = 0; member < k_ - 1; member++) {
-        position++;
-        if (position == DCNetwork_.members().end())
-            position = DCNetwork_.members().begin();
-
-        uint32_t memberIndex = std::distance(DCNetwork_.members().begin(), position);
-
-        // distribute the tuples
-        OutgoingMessage rsMessage(position->second.connectionID(), InitialRoundFirstSharing, DCNetwork_.nodeID(),
-                                  shares_[memberIndex]);
-        DCNetwork_.outbox().push(std::move(rsMessage));
-    }
-}
-
-void UnsecuredInitialRound::sharingPartTwo() {
-    // collect the shares from the other k-1 members and validate them using the broadcasted commitments
-    uint32_t remainingShares = k_ - 1;
-    while (remainingShares > 0) {
-        auto sharingMessage = DCNetwork_.inbox().pop();
-
-        if (sharingMessage.msgType() == InitialRoundFirstSharing) {
-            for (uint32_t p = 0; p < 16 * k_; p++)
-                S[p] ^= sharingMessage.body()[p];
-
-            remainingShares--;
-        } else {
-            DCNetwork_.inbox().push(sharingMessage);
-            std::this_thread::sleep_for(std::chrono::milliseconds(5));
-        }
-    }
-
-    // broadcast the added shares
+void UnsecuredInitialRound::sharing() {
     // ensure that the messages arrive evenly distributed in time
-    auto position = DCNetwork_.members().find(DCNetwork_.nodeID());
-    for (uint32_t member = 0; member < k_ - 1; member++) {
-        position++;
-        if (position == DCNetwork_.members().end())
-            position = DCNetwork_.members().begin();
+    for (uint32_t member = 1; member < k_; member++) {
+        uint32_t memberIndex = (nodeIndex_ + member) % k_;
 
-        OutgoingMessage sharingBroadcast(position->second.connectionID(), InitialRoundSecondSharing, DCNetwork_.nodeID(),
+        OutgoingMessage sharingBroadcast(members_->connectionID(memberIndex), InitialRoundSecondSharing, DCNetwork_.nodeID(),
                                          S);
         DCNetwork_.outbox().push(std::move(sharingBroadcast));
     }
 }
 
 void UnsecuredInitialRound::resultComputation() {
-    // collect the added shares from the other k-1 members and validate them by adding the corresponding commitments
+    // collect the padded vectors from the other k-1 members
     uint32_t remainingShares = k_ - 1;
     while (remainingShares > 0) {
         auto sharingBroadcast = DCNetwork_.inbox().pop();
 
         if (sharingBroadcast.msgType() == InitialRoundSecondSharing) {
             // XOR the received shares
-            for (uint32_t p = 0; p < 16 * k_; p++)
+            size_t size = std::min(S.size(), sharingBroadcast.body().size());
+            for (uint32_t p = 0; p < size; p++)
                 S[p] ^= sharingBroadcast.body()[p];
 
             remainingShares--;
@@ -1,9 +1,11 @@
 #ifndef THREEPP_UNSECUREDINITIALROUND_H
 #define THREEPP_UNSECUREDINITIALROUND_H
 
+#include <memory>
 #include <cryptopp/osrng.h>
 #include <cryptopp/crc.h>
 #include "DCState.h"
+#include "MemberTable.h"
 
 class UnsecuredInitialRound : public DCState {
 public:
@@ -14,11 +16,9 @@ public:
     virtual std::unique_ptr<DCState> executeTask();
 
 private:
-    int preparation();
+    void preparation();
 
-    void sharingPartOne();
-
-    void sharingPartTwo();
+    void sharing();
 
     void resultComputation();
 
@@ -26,15 +26,22 @@ private:
 
     DCNetwork& DCNetwork_;
 
+    // snapshot of the ordered member list at the start of the round
+    std::shared_ptr<const MemberTable> members_;
+
     // DCNetwork size
     size_t k_;
 
     // the position in of the own nodeID in the ordered member list
     size_t nodeIndex_;
 
-    std::vector<std::vector<uint8_t>> shares_;
+    // identifies the pads of this round and of the following final round
+    uint64_t epoch_;
+
+    // positions of the reserved slots in the order of the submitted messages
+    std::vector<uint32_t> reservedSlots_;
 
-    // sum of all shares
+    // sum of all padded vectors
     std::vector<uint8_t> S;
 
     CryptoPP::CRC32 CRC32_;
@@ -0,0 +1,90 @@
+#include <mutex>
+#include <cryptopp/oids.h>
+#include <cryptopp/sha.h>
+#include "VectorCommitment.h"
+#include "DCNetwork.h"
+
+// domain separation of the hash which derives the generators
+const std::string GENERATOR_DOMAIN = "3PP vector commitment generator";
+
+// window size of the fixed base precomputation
+const unsigned PRECOMPUTATION_STORAGE = 16;
+
+namespace {
+    std::mutex generatorMutex;
+
+    std::shared_ptr<const VectorCommitment> cachedGenerators;
+
+    // hashes the index along with a counter to an x-coordinate until a point on the curve is found,
+    // nobody knows the discrete logarithm of the result with respect to G
+    CryptoPP::ECPPoint deriveGenerator(const CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& curve, uint32_t index) {
+        for (uint32_t counter = 0;; counter++) {
+            uint8_t encodedCounters[8];
+            encodedCounters[0] = (index & 0xFF000000) >> 24;
+            encodedCounters[1] = (index & 0x00FF0000) >> 16;
+            encodedCounters[2] = (index & 0x0000FF00) >> 8;
+            encodedCounters[3] = (index & 0x000000FF);
+            encodedCounters[4] = (counter & 0xFF000000) >> 24;
+            encodedCounters[5] = (counter & 0x00FF0000) >> 16;
+            encodedCounters[6] = (counter & 0x0000FF00) >> 8;
+            encodedCounters[7] = (counter & 0x000000FF);
+
+            // compressed point with an even y-coordinate
+            uint8_t encodedPoint[33];
+            encodedPoint[0] = 0x02;
+
+            CryptoPP::SHA256 sha256;
+            sha256.Update(reinterpret_cast<const uint8_t*>(GENERATOR_DOMAIN.data()), GENERATOR_DOMAIN.size());
+            sha256.Update(encodedCounters, sizeof(encodedCounters));
+            sha256.Final(&encodedPoint[1]);
+
+            CryptoPP::ECPPoint generator;
+            if (curve.GetCurve().DecodePoint(generator, encodedPoint, sizeof(encodedPoint)))
+                return generator;
+        }
+    }
+}
+
+std::shared_ptr<const VectorCommitment> VectorCommitment::generators(size_t numSlices) {
+    std::lock_guard<std::mutex> lock(generatorMutex);
+    if (cachedGenerators && (cachedGenerators->size() >= numSlices))
+        return cachedGenerators;
+
+    CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP> curve;
+    curve.Initialize(CryptoPP::ASN1::secp256k1());
+    unsigned maxExponentBits = curve.GetMaxExponent().BitCount();
+
+    // the tables of the existing generators are reused, running rounds keep their own snapshot
+    std::shared_ptr<VectorCommitment> extended(new VectorCommitment());
+    if (cachedGenerators)
+        extended->bases_ = cachedGenerators->bases_;
+
+    extended->bases_.reserve(numSlices + 1);
+    while (extended->bases_.size() < numSlices + 1) {
+        CryptoPP::ECPPoint base = extended->bases_.empty() ? G : deriveGenerator(curve, extended->bases_.size());
+
+        std::shared_ptr<Precomputation> precomputation = std::make_shared<Precomputation>();
+        precomputation->SetBase(curve.GetGroupPrecomputation(), base);
+        precomputation->Precompute(curve.GetGroupPrecomputation(), maxExponentBits, PRECOMPUTATION_STORAGE);
+        extended->bases_.push_back(std::move(precomputation));
+    }
+
+    cachedGenerators = extended;
+    return cachedGenerators;
+}
+
+size_t VectorCommitment::size() const {
+    return bases_.size() - 1;
+}
+
+CryptoPP::ECPPoint VectorCommitment::commit(const CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& curve,
+                                            const CryptoPP::Integer& r,
+                                            const std::vector<CryptoPP::Integer>& slices) const {
+    const CryptoPP::DL_GroupPrecomputation<CryptoPP::ECPPoint>& group = curve.GetGroupPrecomputation();
+
+    CryptoPP::ECPPoint commitment = bases_[0]->Exponentiate(group, r);
+    for (uint32_t slice = 0; slice < slices.size(); slice++)
+        commitment = curve.GetCurve().Add(commitment, bases_[slice + 1]->Exponentiate(group, slices[slice]));
+
+    return commitment;
+}
@@ -0,0 +1,31 @@
+#ifndef THREEPP_VECTORCOMMITMENT_H
+#define THREEPP_VECTORCOMMITMENT_H
+
+#include <memory>
+#include <vector>
+#include <cryptopp/eccrypto.h>
+#include <cryptopp/eprecomp.h>
+
+// Pedersen vector commitment C = r·G + s_1·H_1 + ... + s_n·H_n,
+// which commits to all slices of a share with a single point and a single blinding factor.
+// The generators H_i are derived deterministically, so all members use the same ones.
+class VectorCommitment {
+public:
+    // returns the generators for shares of up to numSlices slices along with their precomputed tables,
+    // the generators are shared between all rounds and extended on demand
+    static std::shared_ptr<const VectorCommitment> generators(size_t numSlices);
+
+    size_t size() const;
+
+    CryptoPP::ECPPoint commit(const CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP>& curve, const CryptoPP::Integer& r,
+                              const std::vector<CryptoPP::Integer>& slices) const;
+
+private:
+    typedef CryptoPP::DL_FixedBasePrecomputationImpl<CryptoPP::ECPPoint> Precomputation;
+
+    // the generator G followed by H_1 ... H_n
+    std::vector<std::shared_ptr<const Precomputation>> bases_;
+};
+
+
+#endif //THREEPP_VECTORCOMMITMENT_H
@@ -4,6 +4,7 @@
 #include <cryptopp/osrng.h>
 #include <cryptopp/oids.h>
 #include <iomanip>
+#include <sstream>
 
 #include "../datastruct/ReceivedMessage.h"
 #include "../network/P2PConnection.h"
@@ -24,17 +25,81 @@ ip::address getIP() {
     return ip_address;
 }
 
+// enables the comma-separated optimizations, returns -1 if an optimization is unknown
+int parseOptimizations(const std::string& list, DCNetworkOptions& options) {
+    std::stringstream stream(list);
+    std::string optimization;
+    while (std::getline(stream, optimization, ',')) {
+        if (optimization == "full")
+            options.fullProtocol = true;
+        else if (optimization == "unvalidated")
+            options.fullProtocol = false;
+        else if (optimization == "prepared")
+            options.preparedCommitments = true;
+        else if (optimization == "seeded")
+            options.seededShares = true;
+        else if (optimization == "vector")
+            options.vectorCommitments = true;
+        else if (optimization == "digests")
+            options.optimisticCommitments = true;
+        else if (optimization == "spotchecks")
+            options.auditRate = 0.1;
+        else if (optimization == "async")
+            options.speculativeVerification = true;
+        else if (optimization == "pipelining")
+            options.pipelining = true;
+        else if (optimization == "multislot")
+            options.maxSlots = 4;
+        else if (optimization == "batching")
+            options.batching = true;
+        else if (optimization == "leases")
+            options.leaseRounds = 10;
+        else if (optimization == "compact")
+            options.compactReservation = true;
+        else if (optimization == "compression")
+            options.compression = true;
+        else if (optimization == "fastrecovery")
+            options.fastRecovery = true;
+        else
+            return -1;
+    }
+
+    // the commitment digests and the spot checks replace the validation of the commitments
+    if (options.optimisticCommitments || (options.auditRate > 0))
+        options.fullProtocol = false;
+    return 0;
+}
+
 int main(int argc, char **argv) {
-    if ((argc < 6) || (atoi(argv[1]) < 0) || (atoi(argv[1]) > 3)) {
-        std::cout << "usage: ./dockerInstance securityLevel numThreads numSenders messageLength propagationDelay optimizationLevel" << std::endl;
+    // the optimizations replace the default ones
+    DCNetworkOptions options;
+    if (argc < 7)
+        parseOptimizations("unvalidated,prepared", options);
+    if ((argc < 6) || (atoi(argv[1]) < 0) || (atoi(argv[1]) > 4)
+        || ((argc >= 7) && (parseOptimizations(argv[6], options) < 0))) {
+        std::cout << "usage: ./dockerInstance securityLevel numThreads numSenders messageLength propagationDelay optimizations auditRate bufferCapacity" << std::endl;
         std::cout << "securityLevel" << std::endl;
         std::cout << "0: unsecured" << std::endl;
         std::cout << "1: secured" << std::endl;
-        std::cout << "2: adaptive" << std::endl;
-        std::cout << "optimizationLevel" << std::endl;
-        std::cout << "0: full Protocol" << std::endl;
-        std::cout << "1: no commitment validation" << std::endl;
-        std::cout << "2: no commitment validation and prepared Commitments" << std::endl;
+        std::cout << "2: adaptive, escalates from unsecured to secured on evidence" << std::endl;
+        std::cout << "3: proof of fairness" << std::endl;
+        std::cout << "4: hybrid" << std::endl;
+        std::cout << "optimizations, comma-separated (default unvalidated,prepared)" << std::endl;
+        std::cout << "full: full Protocol" << std::endl;
+        std::cout << "unvalidated: no commitment validation" << std::endl;
+        std::cout << "prepared: prepared Commitments" << std::endl;
+        std::cout << "seeded: seed-expanded shares" << std::endl;
+        std::cout << "vector: vector commitments in the final round" << std::endl;
+        std::cout << "digests: commitment digests, implies unvalidated" << std::endl;
+        std::cout << "spotchecks: spot checks of a fraction auditRate (default 0.1) of the slices, implies unvalidated" << std::endl;
+        std::cout << "async: asynchronous verification" << std::endl;
+        std::cout << "pipelining: pipelined rounds" << std::endl;
+        std::cout << "multislot: up to 4 slots per sender and round" << std::endl;
+        std::cout << "batching: batching of the submitted messages" << std::endl;
+        std::cout << "leases: slot leases for up to 10 rounds" << std::endl;
+        std::cout << "compact: a single ephemeral key per reservation" << std::endl;
+        std::cout << "compression: compression of the submitted messages" << std::endl;
+        std::cout << "fastrecovery: exclusion of disruptors without a new group setup" << std::endl;
         exit(0);
     }
 
@@ -43,9 +108,12 @@ int main(int argc, char **argv) {
     uint32_t numSenders = atoi(argv[3]);
     uint32_t messageLength = atoi(argv[4]);
     uint32_t propagationDelay = atoi(argv[5]);
-    uint32_t optimizationLevel = 2;
-    if(argc == 7)
-        optimizationLevel = atoi(argv[6]);
+    if((argc >= 8) && (options.auditRate > 0))
+        options.auditRate = atof(argv[7]);
+    // maximum number of payloads in the message buffer
+    uint32_t bufferCapacity = MessageBuffer::DEFAULT_CAPACITY;
+    if(argc >= 9)
+        bufferCapacity = atoi(argv[8]);
 
     // wait for cleaner logging
     std::this_thread::sleep_for(std::chrono::milliseconds(500));
@@ -151,13 +219,25 @@ int main(int argc, char **argv) {
         networkManager.sendMessage(helloMessage);
     }
 
-    std::vector<uint32_t> neighbors = networkManager.neighbors();
+    // the message handler floods to the neighbors, which are connected at the time
+    auto neighbors = [&networkManager]() { return networkManager.neighbors(); };
 
     // wait until all nodes have received the information
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
 
     // start the message handler in a separate thread
-    MessageHandler messageHandler(nodeID_, neighbors, inboxThreePP, inboxDC, outboxThreePP, outboxFinal, propagationDelay);
+    // the batches are unpacked by the message handler
+    // messages which exceed a slot are fragmented with all optimizations,
+    // the compression adds the codec byte to incompressible messages
+    // and the slots of the leased rounds additionally contain the lease header
+    size_t encodedLength = messageLength + (options.compression ? 1 : 0);
+    size_t maxFragmentSize = MessageBatch::MAX_PAYLOAD_SIZE - MessageBatch::FRAME_HEADER_SIZE
+                             - DCNetwork::leaseSize(numNodes + 1, securityLevel, options.leaseRounds,
+                                                    options.pipelining, options.compactReservation);
+    options.fragmentation = (encodedLength > maxFragmentSize);
+    MessageHandler messageHandler(nodeID_, neighbors, inboxThreePP, inboxDC, outboxThreePP, outboxFinal, propagationDelay,
+                                  bufferCapacity, MessageBuffer::DEFAULT_MEMORY, options.batching, options.fragmentation,
+                                  options.compression, maxFragmentSize);
     std::thread messageHandlerThread([&]() {
         messageHandler.run();
     });
@@ -173,16 +253,12 @@ int main(int argc, char **argv) {
         }
     });
 
-    bool fullProtocol = true;
-    bool preparedCommitments = false;
-    if(optimizationLevel > 0)
-        fullProtocol = false;
-    if(optimizationLevel == 2)
-        preparedCommitments = true;
+    options.logging = true;
+    options.lingerTime = 100;
     // start the DCNetwork
     DCMember self(nodeID_, SELF, publicKey);
-    DCNetwork DCNetwork_(self, numNodes + 1, securityLevel, privateKey, numThreads, nodes, inboxDC, outboxThreePP, 0,
-                         fullProtocol, true, preparedCommitments);
+    DCNetwork DCNetwork_(self, numNodes + 1, securityLevel, privateKey, numThreads, nodes, inboxDC, outboxThreePP,
+                         options);
 
     std::thread DCThread([&]() {
         DCNetwork_.run();
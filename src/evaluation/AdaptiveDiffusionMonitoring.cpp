@@ -5,13 +5,13 @@
 #include <iostream>
 #include <fstream>
 #include <cryptopp/oids.h>
-#include <boost/tokenizer.hpp>
 
 #include "../network/P2PConnection.h"
 #include "../network/SecuredNetworkManager.h"
 #include "../network/MessageHandler.h"
 #include "../dc/DCNetwork.h"
 #include "../datastruct/MessageType.h"
+#include "../datastruct/Topology.h"
 #include "../utils/Utils.h"
 #include "../network/NetworkManager.h"
 #include "../ad/AdaptiveDiffusion.h"
@@ -20,43 +20,50 @@
 std::mutex logging_mutex;
 
 const uint32_t iterations = 5;
-const uint32_t INSTANCES = 100;
+uint32_t INSTANCES = 100;
 
-std::vector<std::vector<uint32_t>> topology;
+// directory containing the sample topologies, or the name of a topology generator (regular, smallworld)
+std::string topologySource = "/home/ubuntu/three-phase-protocol-implementation/sample_topologies/";
+uint32_t topologyDegree = 8;
+
+// maximum number of payloads buffered by each instance
+uint32_t bufferCapacity = MessageBuffer::DEFAULT_CAPACITY;
+
+Topology topology;
 
 std::unordered_map<uint32_t, Node> nodes;
 
 std::unordered_map<std::string, std::chrono::system_clock::time_point> startTimes;
 std::unordered_map<std::string, std::vector<double>> sharedArrivalTimes;
 
-std::vector<std::vector<uint32_t>> getTopology(uint32_t graphIndex) {
-    std::stringstream fileName;
-    fileName << "/home/ubuntu/three-phase-protocol-implementation/sample_topologies/";
-    fileName << INSTANCES;
-    fileName << "Nodes/Graph";
-    fileName << graphIndex;
-    fileName << ".csv";
-    std::ifstream in(fileName.str().c_str());
-    if (!in.is_open()) {
-        std::cerr << "Error: could not open file" << std::endl;
-        exit(1);
+// message buffer statistics accumulated over all instances
+MessageBuffer::Statistics bufferStatistics;
+
+Topology getTopology(uint32_t graphIndex) {
+    Topology graph;
+    // the graph index serves as seed of the generators
+    if (topologySource == "regular") {
+        graph = Topology::randomRegular(INSTANCES, topologyDegree, graphIndex);
+    } else if (topologySource == "smallworld") {
+        graph = Topology::smallWorld(INSTANCES, topologyDegree, 0.1, graphIndex);
+    } else {
+        std::stringstream fileName;
+        fileName << topologySource;
+        fileName << INSTANCES;
+        fileName << "Nodes/Graph";
+        fileName << graphIndex;
+
+        // prefer the binary form of the topology if it is available
+        std::string binaryFile = fileName.str() + ".bin";
+        if (std::ifstream(binaryFile).good())
+            graph = Topology::fromBinary(binaryFile);
+        else
+            graph = Topology::fromCSV(fileName.str() + ".csv");
     }
 
-    std::vector<std::vector<uint32_t>> graph;
-    graph.reserve(INSTANCES);
-
-    std::string line;
-    for (uint32_t i = 0; i < INSTANCES; i++) {
-        if (!getline(in, line))
-            break;
-
-        boost::tokenizer<boost::escaped_list_separator<char>> tokenizer(line);
-        std::vector<uint32_t> neighbors;
-        for (auto it = tokenizer.begin(); it != tokenizer.end(); it++) {
-            if (it != tokenizer.begin())
-                neighbors.push_back(std::atoi((*it).c_str()));
-        }
-        graph.push_back(neighbors);
+    if (graph.size() < INSTANCES) {
+        std::cerr << "Error: could not load the topology" << std::endl;
+        exit(1);
     }
     return graph;
 }
@@ -108,7 +115,8 @@ void instance(int ID) {
     std::vector<uint32_t> neighbors = networkManager.neighbors();
 
     // start the message handler in a separate thread
-    MessageHandler messageHandler(nodeID_, neighbors, inboxThreePP, inboxDC, outboxThreePP, outboxFinal, 100, 128);
+    MessageHandler messageHandler(nodeID_, [&networkManager]() { return networkManager.neighbors(); },
+                                  inboxThreePP, inboxDC, outboxThreePP, outboxFinal, 100, bufferCapacity);
     std::thread messageHandlerThread([&]() {
         messageHandler.run();
     });
@@ -212,12 +220,31 @@ void instance(int ID) {
     ReceivedMessage terminateHandler(static_cast<uint8_t>(TerminateMessage));
     inboxThreePP.push(terminateHandler);
     messageHandlerThread.join();
+    {
+        std::lock_guard<std::mutex> lock(logging_mutex);
+        bufferStatistics.duplicatesSuppressed += messageHandler.bufferStatistics().duplicatesSuppressed;
+        bufferStatistics.floodTransitions += messageHandler.bufferStatistics().floodTransitions;
+        bufferStatistics.reFloods += messageHandler.bufferStatistics().reFloods;
+        bufferStatistics.seenTierHits += messageHandler.bufferStatistics().seenTierHits;
+        bufferStatistics.prematureEvictions += messageHandler.bufferStatistics().prematureEvictions;
+        bufferStatistics.expiredPayloads += messageHandler.bufferStatistics().expiredPayloads;
+    }
 
     outboxFinal.push(std::vector<uint8_t>());
     readThread.join();
 }
 
-int main() {
+int main(int argc, char** argv) {
+    // usage: [instances] [topology directory | regular | smallworld] [degree] [buffer capacity]
+    if (argc > 1)
+        INSTANCES = atoi(argv[1]);
+    if (argc > 2)
+        topologySource = argv[2];
+    if (argc > 3)
+        topologyDegree = atoi(argv[3]);
+    if (argc > 4)
+        bufferCapacity = atoi(argv[4]);
+
     for(uint32_t graph = 0; graph < 10; graph++) {
         uint16_t port = 5555;
         topology = getTopology(graph);
@@ -242,7 +269,7 @@ int main() {
         }
 
         std::list<std::thread> threads;
-        for (int i = 0; i < INSTANCES; i++) {
+        for (uint32_t i = 0; i < INSTANCES; i++) {
             std::thread t(instance, i);
             threads.push_back(std::move(t));
         }
@@ -292,5 +319,12 @@ int main() {
     }
     logFile.close();
 
+    std::cout << "Duplicates suppressed: " << bufferStatistics.duplicatesSuppressed << std::endl;
+    std::cout << "Transitions to flood and prune: " << bufferStatistics.floodTransitions << std::endl;
+    std::cout << "Re-floods of evicted payloads: " << bufferStatistics.reFloods << std::endl;
+    std::cout << "Duplicates recognized by the digest tier: " << bufferStatistics.seenTierHits << std::endl;
+    std::cout << "Premature payload evictions: " << bufferStatistics.prematureEvictions << std::endl;
+    std::cout << "Expired payloads: " << bufferStatistics.expiredPayloads << std::endl;
+
     return 0;
 }
\ No newline at end of file
@@ -1,20 +1,42 @@
 #include <iostream>
 #include <thread>
+#include <algorithm>
 #include "MessageHandler.h"
 #include "../datastruct/MessageType.h"
 #include "../ad/AdaptiveDiffusion.h"
 #include "../ad/VirtualSource.h"
+#include "../datastruct/MessageBatch.h"
+#include "../datastruct/MessageCompression.h"
 
-MessageHandler::MessageHandler(uint32_t nodeID, std::vector<uint32_t>& neighbors,
+MessageHandler::MessageHandler(uint32_t nodeID, std::function<std::vector<uint32_t>()> neighbors,
                                MessageQueue<ReceivedMessage>& inboxThreePP, MessageQueue<ReceivedMessage>& inboxDCNet,
                                MessageQueue<OutgoingMessage>& outboxThreePP, MessageQueue<std::vector<uint8_t>>& outboxFinal,
-                               uint32_t propagationDelay, uint32_t msgBufferSize)
+                               uint32_t propagationDelay, uint32_t msgBufferSize, size_t msgBufferMemory,
+                               bool batching, bool fragmentation, bool compression, size_t maxFragmentSize)
         : inboxThreePP_(inboxThreePP), inboxDCNet_(inboxDCNet), outboxThreePP_(outboxThreePP), outboxFinal_(outboxFinal),
-          msgBuffer(msgBufferSize), nodeID_(nodeID), propagationDelay_(propagationDelay), neighbors_(neighbors) {}
+          // the adaptive diffusion phase spans up to 3 * maxDepth propagation steps,
+          // followed by the flood and prune phase
+          msgBuffer(msgBufferSize, msgBufferMemory,
+                    std::chrono::milliseconds(4 * AdaptiveDiffusion::maxDepth * propagationDelay)),
+          nodeID_(nodeID), propagationDelay_(propagationDelay), batching_(batching),
+          fragmentation_(fragmentation), fragments_(msgBufferMemory, maxFragmentSize),
+          compression_(compression), neighbors_(std::move(neighbors)) {}
+
+MessageBuffer::Statistics& MessageHandler::bufferStatistics() {
+    return msgBuffer.statistics();
+}
 
 void MessageHandler::run() {
     for (;;) {
-        auto receivedMessage = inboxThreePP_.pop();
+        MessageHandler::expireRequests();
+
+        // wake up for the next timeout of the pending requests
+        ReceivedMessage receivedMessage;
+        if (requestDeadlines_.empty())
+            receivedMessage = inboxThreePP_.pop();
+        else if (!inboxThreePP_.pop(receivedMessage, requestDeadlines_.begin()->first))
+            continue;
+
         // simulate a network propagation delay
         std::chrono::duration<double> timeDifference = std::chrono::system_clock::now() - receivedMessage.timestamp();
         std::chrono::milliseconds delay = std::chrono::milliseconds(propagationDelay_)
@@ -28,14 +50,20 @@ void MessageHandler::run() {
                 outboxThreePP_.push(std::move(response));
             }
             case DCConnectResponse:
+            case GroupSynchronization:
             case InitialRoundCommitments:
+            case InitialRoundCommitmentDigest:
             case InitialRoundFirstSharing:
             case InitialRoundSecondSharing:
             case InitialRoundFinished:
             case FinalRoundCommitments:
+            case FinalRoundCommitmentDigest:
             case FinalRoundFirstSharing:
             case FinalRoundSecondSharing:
             case FinalRoundFinished:
+            case HybridPayloadSharing:
+            case HybridPayloadVerdict:
+            case RoundMessage:
             case InvalidShare:
             case BlameRoundCommitments:
             case BlameRoundFirstSharing:
@@ -53,31 +81,40 @@ void MessageHandler::run() {
                 break;
             case DCNetworkReceived:
                 msgBuffer.insert(receivedMessage);
-                outboxFinal_.push(receivedMessage.body());
+                MessageHandler::deliver(receivedMessage.body());
                 break;
             case AdaptiveDiffusionForward:
                 if(!msgBuffer.contains(receivedMessage)) {
-                    std::set<uint32_t> neighborSubset;
-                    while(neighborSubset.size() < std::min(AdaptiveDiffusion::Eta, neighbors_.size()-1)) {
-                        uint32_t neighbor = PRNG.GenerateWord32(0, neighbors_.size()-1);
-                        if(neighbor != receivedMessage.senderID())
-                            neighborSubset.insert(neighbors_[neighbor]);
-                    }
+                    std::vector<uint32_t> neighborSubset = AdaptiveDiffusion::selectNeighbors(
+                            neighbors_(), receivedMessage.connectionID(), PRNG);
                     msgBuffer.insert(receivedMessage, std::move(neighborSubset));
-                    outboxFinal_.push(receivedMessage.body());
+                    msgBuffer.markPeer(receivedMessage, receivedMessage.connectionID());
+                    completeRequest(receivedMessage);
+                    MessageHandler::deliver(receivedMessage.body());
                 } else if(receivedMessage.senderID() == msgBuffer.getSenderID(receivedMessage)) {
-                    std::set<uint32_t> neighborSubset = msgBuffer.getSelectedNeighbors(receivedMessage);
+                    std::vector<uint32_t> neighborSubset = msgBuffer.getSelectedNeighbors(receivedMessage);
                     for(uint32_t neighbor : neighborSubset) {
                         OutgoingMessage adForward(neighbor, AdaptiveDiffusionForward, nodeID_, receivedMessage.body());
                         outboxThreePP_.push(std::move(adForward));
+                        msgBuffer.markPeer(receivedMessage, neighbor);
                     }
+                } else {
+                    msgBuffer.markPeer(receivedMessage, receivedMessage.connectionID());
+                    msgBuffer.statistics().duplicatesSuppressed++;
                 }
                 break;
             case VirtualSourceToken: {
-                std::string msgHash(&receivedMessage.body()[4], &receivedMessage.body()[36]);
-                std::vector<uint8_t> message = msgBuffer.getMessage(msgHash).body();
+                MessageDigest msgHash;
+                std::copy(&receivedMessage.body()[4], &receivedMessage.body()[36], msgHash.begin());
+                auto payload = msgBuffer.getPayload(msgHash);
+                if(!payload) {
+                    std::cout << "VS Token received for an unknown message" << std::endl;
+                    break;
+                }
+                std::vector<uint8_t> message = *payload;
                 std::thread virtualSourceThread([=]() {
-                    VirtualSource virtualSource(nodeID_, neighbors_, outboxThreePP_, inboxThreePP_, message, receivedMessage);
+                    std::vector<uint32_t> neighbors = neighbors_();
+                    VirtualSource virtualSource(nodeID_, neighbors, outboxThreePP_, inboxThreePP_, message, receivedMessage);
                     virtualSource.executeTask();
                 });
                 virtualSourceThread.detach();
@@ -87,22 +124,91 @@ void MessageHandler::run() {
                 if(!msgBuffer.contains(receivedMessage)) {
                     // Add the message to the message buffer
                     msgBuffer.insert(receivedMessage);
+                    msgBuffer.markPeer(receivedMessage, receivedMessage.connectionID());
+                    completeRequest(receivedMessage);
 
                     // flood the message
-                    OutgoingMessage floodMessage(BROADCAST, FloodAndPrune, nodeID_,
-                                                 receivedMessage.body());
-                    outboxThreePP_.push(std::move(floodMessage));
+                    MessageHandler::flood(receivedMessage);
 
                     // pass the received message to the upper layer
-                    outboxFinal_.push(std::move(receivedMessage.body()));
+                    MessageHandler::deliver(std::move(receivedMessage.body()));
                 } else if(msgBuffer.getType(receivedMessage) != FloodAndPrune) {
+                    if(msgBuffer.getPayload(receivedMessage.digest()))
+                        msgBuffer.statistics().floodTransitions++;
+                    else
+                        msgBuffer.statistics().reFloods++;
+
                     // only updates the message type
                     msgBuffer.insert(receivedMessage);
+                    msgBuffer.markPeer(receivedMessage, receivedMessage.connectionID());
+                    completeRequest(receivedMessage);
 
                     // flood the message
-                    OutgoingMessage floodMessage(BROADCAST, FloodAndPrune, nodeID_,
-                                                 receivedMessage.body());
-                    outboxThreePP_.push(std::move(floodMessage));
+                    MessageHandler::flood(receivedMessage);
+                } else {
+                    msgBuffer.markPeer(receivedMessage, receivedMessage.connectionID());
+                    msgBuffer.statistics().duplicatesSuppressed++;
+                }
+                break;
+            }
+            case FloodAndPruneAnnouncement: {
+                if(receivedMessage.body().size() < 32)
+                    break;
+
+                MessageDigest msgHash;
+                std::copy(receivedMessage.body().begin(), receivedMessage.body().begin() + 32, msgHash.begin());
+                uint32_t announcer = receivedMessage.connectionID();
+
+                if(msgBuffer.contains(msgHash)) {
+                    msgBuffer.markPeer(msgHash, announcer);
+                    if(msgBuffer.getType(msgHash) == FloodAndPrune) {
+                        msgBuffer.statistics().duplicatesSuppressed++;
+                        break;
+                    }
+
+                    // the flood and prune phase has been reached, continue with it
+                    auto payload = msgBuffer.getPayload(msgHash);
+                    if(payload) {
+                        ReceivedMessage floodMessage(announcer, FloodAndPrune, receivedMessage.senderID(), *payload);
+                        msgBuffer.insert(floodMessage);
+                        msgBuffer.statistics().floodTransitions++;
+
+                        MessageHandler::flood(floodMessage);
+                        break;
+                    }
+                    // the payload of the adaptive diffusion phase has already been evicted,
+                    // it is requested like an unknown payload and flooded once it arrives
+                }
+
+                auto request = pendingRequests_.find(msgHash);
+                if(request == pendingRequests_.end()) {
+                    // pull the payload from the first announcer
+                    PendingRequest& newRequest = pendingRequests_[msgHash];
+                    newRequest.announcers.push_back(announcer);
+                    requestPayload(msgHash, newRequest);
+                } else if((std::find(request->second.announcers.begin(), request->second.announcers.end(), announcer)
+                           == request->second.announcers.end())
+                          && (std::find(request->second.timedOut.begin(), request->second.timedOut.end(), announcer)
+                              == request->second.timedOut.end())) {
+                    // remember the announcer as fallback, during the retry it is asked right away
+                    request->second.announcers.push_back(announcer);
+                    if(request->second.announcers.size() == 1)
+                        requestPayload(msgHash, request->second);
+                }
+                break;
+            }
+            case FloodAndPruneRequest: {
+                if(receivedMessage.body().size() < 32)
+                    break;
+
+                MessageDigest msgHash;
+                std::copy(receivedMessage.body().begin(), receivedMessage.body().begin() + 32, msgHash.begin());
+
+                auto payload = msgBuffer.getPayload(msgHash);
+                if(payload) {
+                    OutgoingMessage response(receivedMessage.connectionID(), FloodAndPrune, nodeID_, *payload);
+                    outboxThreePP_.push(std::move(response));
+                    msgBuffer.markPeer(msgHash, receivedMessage.connectionID());
                 }
                 break;
             }
@@ -113,3 +219,121 @@ void MessageHandler::run() {
         }
     }
 }
+
+void MessageHandler::deliver(std::vector<uint8_t> payload) {
+    if (!batching_) {
+        MessageHandler::deliverMessage(std::move(payload));
+        return;
+    }
+
+    for (auto& message : MessageBatch::unpack(payload))
+        MessageHandler::deliverMessage(std::move(message));
+}
+
+void MessageHandler::deliverMessage(std::vector<uint8_t> message) {
+    if (fragmentation_) {
+        std::vector<uint8_t> reassembledMessage;
+        if (!fragments_.reassemble(message, reassembledMessage))
+            return;
+        message = std::move(reassembledMessage);
+    }
+
+    if (compression_) {
+        std::vector<uint8_t> decodedMessage;
+        if (MessageCompression::decode(message, decodedMessage) < 0) {
+            std::cout << "Error: could not decompress the received message" << std::endl;
+            return;
+        }
+        message = std::move(decodedMessage);
+    }
+
+    outboxFinal_.push(std::move(message));
+}
+
+void MessageHandler::flood(ReceivedMessage& msg) {
+    // large payloads are only announced in the lazy push mode,
+    // evicted payloads are pushed since they could not be served on request
+    bool announce = AdaptiveDiffusion::lazyPush && (msg.body().size() >= AdaptiveDiffusion::lazyPushThreshold)
+                    && msgBuffer.getPayload(msg.digest());
+
+    // skip the neighbors which already delivered the message or to which it has already been sent
+    for(uint32_t neighbor : neighbors_()) {
+        if(!msgBuffer.peerHasMessage(msg, neighbor)) {
+            if(announce) {
+                std::vector<uint8_t> announcement(msg.digest().begin(), msg.digest().end());
+                OutgoingMessage floodMessage(neighbor, FloodAndPruneAnnouncement, nodeID_, std::move(announcement));
+                outboxThreePP_.push(std::move(floodMessage));
+            } else {
+                OutgoingMessage floodMessage(neighbor, FloodAndPrune, nodeID_, msg.body());
+                outboxThreePP_.push(std::move(floodMessage));
+            }
+            msgBuffer.markPeer(msg, neighbor);
+        }
+    }
+}
+
+void MessageHandler::requestPayload(const MessageDigest& digest, PendingRequest& request) {
+    std::vector<uint8_t> requestBody(digest.begin(), digest.end());
+    OutgoingMessage requestMessage(request.announcers.front(), FloodAndPruneRequest, nodeID_, requestBody);
+    outboxThreePP_.push(std::move(requestMessage));
+
+    // both the request and the response are delayed by the propagation delay
+    request.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(4 * propagationDelay_);
+    requestDeadlines_.insert(std::pair(request.deadline, digest));
+}
+
+void MessageHandler::expireRequests() {
+    auto now = std::chrono::steady_clock::now();
+    while (!requestDeadlines_.empty() && (requestDeadlines_.begin()->first <= now)) {
+        auto deadline = requestDeadlines_.begin()->first;
+        MessageDigest digest = requestDeadlines_.begin()->second;
+        requestDeadlines_.erase(requestDeadlines_.begin());
+
+        // ignore the timeout if the payload has been received or a newer request has been sent
+        auto request = pendingRequests_.find(digest);
+        if ((request == pendingRequests_.end()) || (request->second.deadline != deadline))
+            continue;
+
+        // fall back to the next announcer
+        if (!request->second.announcers.empty()) {
+            request->second.timedOut.push_back(request->second.announcers.front());
+            request->second.announcers.pop_front();
+        }
+        if (!request->second.announcers.empty()) {
+            requestPayload(digest, request->second);
+        } else if (!request->second.retried) {
+            // the requests or the responses may have been delayed, which does not affect the other announcers
+            MessageHandler::retryRequest(digest, request->second);
+        } else {
+            // the message is requested again if another neighbor announces it
+            std::cout << "Error: the announced payload could not be retrieved" << std::endl;
+            pendingRequests_.erase(request);
+        }
+    }
+}
+
+void MessageHandler::retryRequest(const MessageDigest& digest, PendingRequest& request) {
+    std::vector<uint8_t> requestBody(digest.begin(), digest.end());
+    for (uint32_t announcer : request.timedOut) {
+        OutgoingMessage requestMessage(announcer, FloodAndPruneRequest, nodeID_, requestBody);
+        outboxThreePP_.push(std::move(requestMessage));
+    }
+    request.retried = true;
+
+    // the retry waits twice as long as a single request
+    request.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(8 * propagationDelay_);
+    requestDeadlines_.insert(std::pair(request.deadline, digest));
+}
+
+void MessageHandler::completeRequest(ReceivedMessage& msg) {
+    auto request = pendingRequests_.find(msg.digest());
+    if(request == pendingRequests_.end())
+        return;
+
+    for(uint32_t announcer : request->second.announcers)
+        msgBuffer.markPeer(msg, announcer);
+    for(uint32_t announcer : request->second.timedOut)
+        msgBuffer.markPeer(msg, announcer);
+
+    pendingRequests_.erase(request);
+}
\ No newline at end of file
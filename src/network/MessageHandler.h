@@ -2,22 +2,68 @@
 #define THREEPP_MESSAGEHANDLER_H
 
 #include <set>
+#include <map>
+#include <deque>
+#include <functional>
 #include <cryptopp/osrng.h>
 #include "../datastruct/OutgoingMessage.h"
 #include "../datastruct/MessageQueue.h"
 #include "../datastruct/ReceivedMessage.h"
 #include "../datastruct/MessageBuffer.h"
+#include "../datastruct/MessageFragmentation.h"
 
 class MessageHandler {
 public:
-    MessageHandler(uint32_t nodeID, std::vector<uint32_t>& neighbors,
+    // the neighbors are queried from the network manager for each message,
+    // since neighbors connect after the message handler has been started
+    MessageHandler(uint32_t nodeID, std::function<std::vector<uint32_t>()> neighbors,
             MessageQueue<ReceivedMessage>& inboxThreePP, MessageQueue<ReceivedMessage>& inboxDCNet,
             MessageQueue<OutgoingMessage>& outboxThreePP, MessageQueue<std::vector<uint8_t>>& outboxFinal,
-            uint32_t propagationDelay = 100, uint32_t msgBufferSize = 128);
+            uint32_t propagationDelay = 100, uint32_t msgBufferSize = MessageBuffer::DEFAULT_CAPACITY,
+            size_t msgBufferMemory = MessageBuffer::DEFAULT_MEMORY,
+            bool batching = false, bool fragmentation = false, bool compression = false,
+            size_t maxFragmentSize = MessageFragmentation::MAX_FRAGMENT_SIZE);
 
     void run();
 
+    MessageBuffer::Statistics& bufferStatistics();
+
 private:
+    // outstanding payload request of the lazy push mode
+    struct PendingRequest {
+        // connections which announced the message, the payload is requested from the first one
+        std::deque<uint32_t> announcers;
+
+        // announcers whose requests timed out, they are asked again at once after all announcers have been tried
+        std::vector<uint32_t> timedOut;
+
+        // determines whether the payload has already been requested from all announcers at once
+        bool retried = false;
+
+        // distinguishes the timeouts of the individual requests
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    void flood(ReceivedMessage& msg);
+
+    // passes a received payload to the upper layer, batched payloads are split into their messages
+    // and fragmented messages are delivered once they are complete and decompressed
+    void deliver(std::vector<uint8_t> payload);
+
+    void deliverMessage(std::vector<uint8_t> message);
+
+    void requestPayload(const MessageDigest& digest, PendingRequest& request);
+
+    // requests the payload from all announcers at once after each of them timed out
+    void retryRequest(const MessageDigest& digest, PendingRequest& request);
+
+    // falls back to the next announcer of each request whose timeout elapsed,
+    // the request is dropped only if the final retry times out as well
+    void expireRequests();
+
+    // all announcers hold the message, therefore the payload is not announced back to them
+    void completeRequest(ReceivedMessage& msg);
+
     MessageQueue<ReceivedMessage>& inboxThreePP_;
 
     MessageQueue<ReceivedMessage>& inboxDCNet_;
@@ -28,11 +74,26 @@ private:
 
     MessageBuffer msgBuffer;
 
+    std::map<MessageDigest, PendingRequest> pendingRequests_;
+
+    // timeouts of the pending requests, checked by the message handler thread
+    std::multimap<std::chrono::steady_clock::time_point, MessageDigest> requestDeadlines_;
+
     uint32_t nodeID_;
 
     uint32_t propagationDelay_;
 
-    std::vector<uint32_t>& neighbors_;
+    // determines whether the payloads of the DC network contain batches of messages
+    bool batching_;
+
+    bool fragmentation_;
+
+    // bounded by the same amount of memory as the message buffer
+    MessageFragmentation fragments_;
+
+    bool compression_;
+
+    std::function<std::vector<uint32_t>()> neighbors_;
 
     CryptoPP::AutoSeededRandomPool PRNG;
 };
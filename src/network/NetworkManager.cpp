@@ -93,7 +93,7 @@ std::vector<uint32_t> NetworkManager::neighbors() {
 }
 
 void NetworkManager::storeNeighbor(uint32_t connectionID) {
-    std::lock_guard<std::mutex> lock(connectionMutex_);
+    std::lock_guard<std::mutex> lock(neighborMutex_);
     neighbors_.push_back(connectionID);
 }
 
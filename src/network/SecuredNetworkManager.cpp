@@ -93,6 +93,7 @@ int SecuredNetworkManager::sendMessage(OutgoingMessage msg) {
 }
 
 std::vector<uint32_t> SecuredNetworkManager::neighbors() {
+    std::lock_guard<std::mutex> lock(neighborMutex_);
     return neighbors_;
 }
 
@@ -123,7 +123,8 @@ void instance(int ID) {
 
     // wait until all nodes are connected
     std::this_thread::sleep_for(std::chrono::seconds(1));
-    std::vector<uint32_t> neighbors = networkManager.neighbors();
+    // the message handler floods to the neighbors, which are connected at the time
+    auto neighbors = [&networkManager]() { return networkManager.neighbors(); };
 
     // start the message handler in a separate thread
     MessageHandler messageHandler(nodeID_, neighbors, inboxThreePP, inboxDC, outboxThreePP, outboxFinal, 100);
@@ -144,8 +145,7 @@ void instance(int ID) {
 
     // start the DCNetwork
     DCMember self(nodeID_, SELF, publicKey);
-    DCNetwork DCNet(self, INSTANCES, Secured, privateKey, 2, nodes, inboxDC,
-            outboxThreePP, 0, true,false, false);
+    DCNetwork DCNet(self, INSTANCES, Secured, privateKey, 2, nodes, inboxDC, outboxThreePP);
 
     // submit messages to the DCNetwork
     for (uint32_t i = 0; i < iterations; i++) {
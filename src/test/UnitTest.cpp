@@ -0,0 +1,264 @@
+#include <cryptopp/eccrypto.h>
+#include <cryptopp/oids.h>
+#include <cryptopp/osrng.h>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../datastruct/MessageCompression.h"
+#include "../datastruct/MessageFragmentation.h"
+#include "../datastruct/MessageType.h"
+#include "../datastruct/Topology.h"
+#include "../dc/MemberTable.h"
+#include "../dc/SpotCheck.h"
+#include "../network/MessageHandler.h"
+#include "../utils/Utils.h"
+
+// Unit tests of the self-contained data structures and helpers, exits with 1 if a check fails.
+
+uint32_t failures = 0;
+
+void check(bool condition, const std::string& description) {
+    if (!condition) {
+        std::cout << "FAILED: " << description << std::endl;
+        failures++;
+    }
+}
+
+void testMessageCompression() {
+    // a repetitive message is compressed and restored
+    std::vector<uint8_t> message(4096);
+    for (uint32_t i = 0; i < message.size(); i++)
+        message[i] = i % 16;
+
+    std::vector<uint8_t> encoded = MessageCompression::encode(message);
+    check(encoded[0] == MessageCompression::Deflate, "compressible message is deflated");
+    check(encoded.size() < message.size(), "deflated message is shorter");
+
+    std::vector<uint8_t> decoded;
+    check(MessageCompression::decode(encoded, decoded) == 0, "deflated message is decoded");
+    check(decoded == message, "deflated message is restored");
+
+    // the announced length is enforced
+    check(MessageCompression::decode(encoded, decoded, message.size() - 1) < 0, "decode respects maxSize");
+    std::vector<uint8_t> wrongLength = encoded;
+    wrongLength[4]++;
+    check(MessageCompression::decode(wrongLength, decoded) < 0, "decode rejects a wrong length");
+    std::vector<uint8_t> truncated(encoded.begin(), encoded.begin() + MessageCompression::DEFLATE_HEADER_SIZE + 4);
+    check(MessageCompression::decode(truncated, decoded) < 0, "decode rejects truncated data");
+
+    // short messages are sent raw
+    std::vector<uint8_t> shortMessage = {1, 2, 3};
+    encoded = MessageCompression::encode(shortMessage);
+    check(encoded[0] == MessageCompression::Raw, "short message is sent raw");
+    check((MessageCompression::decode(encoded, decoded) == 0) && (decoded == shortMessage), "raw message is restored");
+
+    encoded[0] = 0xFF;
+    check(MessageCompression::decode(encoded, decoded) < 0, "decode rejects an unknown codec");
+}
+
+void testSpotCheck() {
+    CryptoPP::AutoSeededRandomPool PRNG;
+    CryptoPP::DL_GroupParameters_EC<CryptoPP::ECP> curve;
+    curve.Initialize(CryptoPP::ASN1::secp256k1());
+
+    check(SpotCheck::sample(PRNG, 100, 0).empty(), "no slice is sampled at rate 0");
+    check(SpotCheck::sample(PRNG, 100, 1).size() == 100, "every slice is sampled at rate 1");
+
+    const size_t numSlices = 8;
+    std::vector<CryptoPP::Integer> rValues;
+    std::vector<CryptoPP::Integer> slices;
+    std::vector<CryptoPP::ECPPoint> commitments;
+    for (uint32_t i = 0; i < numSlices; i++) {
+        rValues.push_back(CryptoPP::Integer(PRNG, CryptoPP::Integer::One(), curve.GetMaxExponent()));
+        slices.push_back(CryptoPP::Integer(PRNG, CryptoPP::Integer::One(), curve.GetMaxExponent()));
+        commitments.push_back(SpotCheck::commit(curve, rValues[i], slices[i]));
+    }
+    check(SpotCheck::opens(curve, commitments[0], rValues[0], slices[0]), "a commitment opens to its values");
+    check(!SpotCheck::opens(curve, commitments[0], rValues[0], slices[1]), "a commitment rejects other values");
+    check(SpotCheck::verify(curve, PRNG, rValues, slices, commitments) == -1, "valid slices pass the batch check");
+
+    // a single invalid slice is located
+    slices[5] += 1;
+    check(SpotCheck::verify(curve, PRNG, rValues, slices, commitments) == 5, "the invalid slice is located");
+
+    size_t numAudited = 0;
+    int invalid = SpotCheck::audit(curve, PRNG, 1, rValues, slices,
+                                   [&](uint32_t slice) { return commitments[slice]; }, numAudited);
+    check((invalid == 5) && (numAudited == numSlices), "a full audit locates the invalid slice");
+    invalid = SpotCheck::audit(curve, PRNG, 0, rValues, slices,
+                               [&](uint32_t slice) { return commitments[slice]; }, numAudited);
+    check((invalid == -1) && (numAudited == 0), "no slice is audited at rate 0");
+}
+
+void testMemberTable() {
+    std::map<uint32_t, DCMember> members;
+    members.emplace(42, DCMember(42, 7));
+    members.emplace(5, DCMember(5, 3));
+    members.emplace(17, DCMember(17, 9));
+
+    MemberTable table(members);
+    check(table.size() == 3, "the table contains all members");
+    check((table.index(5) == 0) && (table.index(17) == 1) && (table.index(42) == 2), "members are ordered by ID");
+    check(table.index(6) == -1, "non-members have no index");
+    check((table.nodeID(1) == 17) && (table.connectionID(1) == 9), "the index addresses the member");
+}
+
+void testTopology() {
+    std::string fileName = "unitTestTopology.bin";
+    Topology topology = Topology::randomRegular(16, 4, 1);
+    check(topology.writeBinary(fileName) == 0, "the topology is written");
+
+    Topology loaded = Topology::fromBinary(fileName);
+    bool equal = (loaded.size() == topology.size()) && (loaded.numEdges() == topology.numEdges());
+    for (uint32_t node = 0; equal && (node < topology.size()); node++)
+        equal = std::vector<uint32_t>(loaded[node].begin(), loaded[node].end())
+                == std::vector<uint32_t>(topology[node].begin(), topology[node].end());
+    check(equal, "the topology is restored");
+
+    // a neighbor outside of the graph is rejected
+    FILE* file = std::fopen(fileName.c_str(), "r+b");
+    std::fseek(file, -4, SEEK_END);
+    uint32_t node = 99;
+    std::fwrite(&node, sizeof(node), 1, file);
+    std::fclose(file);
+    check(Topology::fromBinary(fileName).size() == 0, "an invalid neighbor is rejected");
+
+    // a node count, which does not match the file size, is rejected
+    file = std::fopen(fileName.c_str(), "r+b");
+    std::fseek(file, 4, SEEK_SET);
+    node = 0xFFFFFFFF;
+    std::fwrite(&node, sizeof(node), 1, file);
+    std::fclose(file);
+    check(Topology::fromBinary(fileName).size() == 0, "an invalid node count is rejected");
+
+    std::remove(fileName.c_str());
+    check(Topology::fromBinary(fileName).size() == 0, "a missing file is rejected");
+}
+
+void testMessageFragmentation() {
+    std::vector<uint8_t> message(2 * MessageFragmentation::MAX_FRAGMENT_DATA_SIZE + 10);
+    for (uint32_t i = 0; i < message.size(); i++)
+        message[i] = i & 0xFF;
+
+    std::vector<std::vector<uint8_t>> fragments = MessageFragmentation::split(message, 1);
+    check(fragments.size() == 3, "the message is split into three fragments");
+
+    // the fragments are reassembled in any order
+    MessageFragmentation fragmentation;
+    std::vector<uint8_t> reassembled;
+    check(!fragmentation.reassemble(fragments[2], reassembled), "the last fragment alone is incomplete");
+    check(!fragmentation.reassemble(fragments[0], reassembled), "two fragments are incomplete");
+    check(!fragmentation.reassemble(fragments[0], reassembled), "a duplicate fragment is ignored");
+    check(fragmentation.reassemble(fragments[1], reassembled), "the last missing fragment completes the message");
+    check(reassembled == message, "the message is restored");
+
+    // interleaved messages are kept apart
+    std::vector<uint8_t> other(message.rbegin(), message.rend());
+    std::vector<std::vector<uint8_t>> otherFragments = MessageFragmentation::split(other, 2);
+    fragments = MessageFragmentation::split(message, 3);
+    for (uint32_t i = 0; i < 2; i++) {
+        check(!fragmentation.reassemble(fragments[i], reassembled), "interleaved fragment is incomplete");
+        check(!fragmentation.reassemble(otherFragments[i], reassembled), "interleaved fragment is incomplete");
+    }
+    check(fragmentation.reassemble(otherFragments[2], reassembled) && (reassembled == other),
+          "the interleaved message is restored");
+    check(fragmentation.reassemble(fragments[2], reassembled) && (reassembled == message),
+          "the first message is restored");
+
+    // malformed fragments are rejected
+    std::vector<uint8_t> header(fragments[0].begin(), fragments[0].begin() + 4);
+    check(!fragmentation.reassemble(header, reassembled), "a truncated header is rejected");
+    std::vector<uint8_t> shortFragment(fragments[0].begin(), fragments[0].end() - 1);
+    check(!fragmentation.reassemble(shortFragment, reassembled), "a short inner fragment is rejected");
+
+    // messages, which exceed the reassembly memory, are rejected
+    MessageFragmentation bounded(MessageFragmentation::MAX_FRAGMENT_DATA_SIZE);
+    check(!bounded.reassemble(fragments[0], reassembled), "an oversized message is rejected");
+
+    // the fragments of a leased slot leave room for the lease header
+    size_t maxFragmentSize = MessageFragmentation::MAX_FRAGMENT_SIZE - 4 - 33 * 5;
+    fragments = MessageFragmentation::split(message, 4, maxFragmentSize);
+    check(fragments[0].size() == maxFragmentSize, "the fragments are limited to the given size");
+    MessageFragmentation leased(MessageBuffer::DEFAULT_MEMORY, maxFragmentSize);
+    bool complete = false;
+    for (auto& fragment : fragments)
+        complete = leased.reassemble(fragment, reassembled);
+    check(complete && (reassembled == message), "the message is restored from the smaller fragments");
+
+    MessageBatch batch(maxFragmentSize + MessageBatch::FRAME_HEADER_SIZE);
+    check(batch.add(fragments[0]), "a fragment fits into a batch of the leased slot");
+    check(!batch.add(fragments.back()), "the batch does not exceed the leased slot");
+}
+
+// receivers of the payload requests, collected until the message handler stays silent for the given time
+std::vector<uint32_t> requestReceivers(MessageQueue<OutgoingMessage>& outbox, std::chrono::milliseconds silence) {
+    std::vector<uint32_t> receivers;
+    OutgoingMessage message(0, 0, 0);
+    while (outbox.pop(message, std::chrono::steady_clock::now() + silence)) {
+        if (message.msgType() == FloodAndPruneRequest)
+            receivers.push_back(message.receiverID());
+    }
+    return receivers;
+}
+
+void announce(MessageQueue<ReceivedMessage>& inbox, uint32_t announcer, const MessageDigest& digest) {
+    ReceivedMessage announcement(announcer, FloodAndPruneAnnouncement, announcer,
+                                 std::vector<uint8_t>(digest.begin(), digest.end()));
+    announcement.timestamp(std::chrono::system_clock::now());
+    inbox.push(std::move(announcement));
+}
+
+void testLazyPushRequests() {
+    MessageQueue<ReceivedMessage> inboxThreePP;
+    MessageQueue<ReceivedMessage> inboxDCNet;
+    MessageQueue<OutgoingMessage> outboxThreePP;
+    MessageQueue<std::vector<uint8_t>> outboxFinal;
+    const uint32_t propagationDelay = 10;
+    MessageHandler handler(1, []() { return std::vector<uint32_t>{2, 3}; }, inboxThreePP, inboxDCNet, outboxThreePP,
+                           outboxFinal, propagationDelay);
+    std::thread handlerThread([&handler]() { handler.run(); });
+
+    std::vector<uint8_t> payload(2048, 7);
+    MessageDigest digest = utils::sha256Digest(payload);
+
+    // every announcer times out, then all of them are asked again at once before the request is dropped
+    announce(inboxThreePP, 2, digest);
+    announce(inboxThreePP, 3, digest);
+    std::vector<uint32_t> receivers = requestReceivers(outboxThreePP, std::chrono::milliseconds(20 * propagationDelay));
+    check(receivers == std::vector<uint32_t>({2, 3, 2, 3}), "the announcers are asked in turn and then at once");
+    check(outboxFinal.empty(), "no payload is delivered without a response");
+
+    // a later announcement restarts the request, the response is delivered
+    announce(inboxThreePP, 2, digest);
+    receivers = requestReceivers(outboxThreePP, std::chrono::milliseconds(2 * propagationDelay));
+    check(receivers == std::vector<uint32_t>({2}), "a dropped request is restarted by a new announcement");
+
+    ReceivedMessage response(2, FloodAndPrune, 2, payload);
+    response.timestamp(std::chrono::system_clock::now());
+    inboxThreePP.push(std::move(response));
+    std::vector<uint8_t> delivered;
+    check(outboxFinal.pop(delivered, std::chrono::steady_clock::now() + std::chrono::milliseconds(10 * propagationDelay))
+          && (delivered == payload), "the requested payload is delivered");
+
+    inboxThreePP.push(ReceivedMessage(static_cast<uint8_t>(TerminateMessage)));
+    handlerThread.join();
+}
+
+int main() {
+    testMessageCompression();
+    testSpotCheck();
+    testMemberTable();
+    testTopology();
+    testMessageFragmentation();
+    testLazyPushRequests();
+
+    if (failures > 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
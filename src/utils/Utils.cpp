@@ -14,3 +14,12 @@ std::string utils::sha256(std::vector<uint8_t>& data) {
     sha256.Final(reinterpret_cast<CryptoPP::byte*>(hash.data()));
     return hash;
 }
+
+std::array<uint8_t, 32> utils::sha256Digest(const std::vector<uint8_t>& data) {
+    CryptoPP::SHA256 sha256;
+
+    std::array<uint8_t, 32> digest;
+    sha256.Update(reinterpret_cast<const CryptoPP::byte*>(data.data()), data.size());
+    sha256.Final(reinterpret_cast<CryptoPP::byte*>(digest.data()));
+    return digest;
+}
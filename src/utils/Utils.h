@@ -1,6 +1,7 @@
 #ifndef THREEPP_UTILS_H
 #define THREEPP_UTILS_H
 
+#include <array>
 #include <vector>
 #include <openssl/evp.h>
 #include <cryptopp/ecpoint.h>
@@ -8,6 +9,9 @@
 
 namespace utils {
     std::string sha256(std::vector<uint8_t>& data);
+
+    // CryptoPP selects the SHA-NI implementation at runtime if the CPU supports it
+    std::array<uint8_t, 32> sha256Digest(const std::vector<uint8_t>& data);
 };
 
 